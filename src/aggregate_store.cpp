@@ -0,0 +1,220 @@
+#include "aggregate_store.h"
+#include "civil_date.h"
+#include "sqlite_statement.h"
+#include "utilities.h"
+#include <cmath>
+#include <stdexcept>
+
+void AggregateStore::rebuild(Storage &storage, const double &in_std_drink_size) {
+    /*
+     * Recalculate every total with one scan of the drinks table. If the scan fails, the store is left invalid and
+     * this throws.
+     * @param storage: A storage instance.
+     * @param in_std_drink_size: Size of a standard drink, in oz.
+     */
+
+    valid = false;
+    days.clear();
+    types.clear();
+    drink_count = 0;
+    streaks_stale = true;
+    std_drink_size = in_std_drink_size;
+
+    // Reused so reading the text columns doesn't allocate once they have grown
+    std::string alcohol_type;
+    std::string producer;
+    std::string name;
+    std::string type;
+    const auto read_text = [](std::string &value, sqlite3_stmt *statement, const int column) {
+        const auto *text = reinterpret_cast<const char *>(sqlite3_column_text(statement, column));
+        value.assign(text ? text : "", static_cast<std::size_t>(sqlite3_column_bytes(statement, column)));
+    };
+
+    auto connection = Database::connection(storage);
+    const Statement statement {prepare_statement(connection.get(), "SELECT day, abv, _size, ibu, alcohol_type, producer, "
+                                                                   "drink_name, drink_type FROM drinks")};
+    int rc;
+    while ((rc = sqlite3_step(statement.get())) == SQLITE_ROW) {
+        read_text(alcohol_type, statement.get(), 4);
+        read_text(producer, statement.get(), 5);
+        read_text(name, statement.get(), 6);
+        read_text(type, statement.get(), 7);
+        apply(sqlite3_column_int(statement.get(), 0), sqlite3_column_double(statement.get(), 1),
+              sqlite3_column_double(statement.get(), 2), sqlite3_column_double(statement.get(), 3), alcohol_type,
+              producer, name, type, 1);
+    }
+    if (rc != SQLITE_DONE) {
+        throw std::runtime_error(std::string("Failed to read drinks for the totals: ") +
+                                 sqlite3_errmsg(connection.get()));
+    }
+
+    valid = true;
+}
+
+void AggregateStore::invalidate() {
+    /*
+     * Mark the totals as stale, e.g. after drinks were written without going through the store. The next stats
+     * refresh rebuilds them.
+     */
+
+    valid = false;
+}
+
+bool AggregateStore::valid_for(const double &in_std_drink_size) const {
+    /*
+     * Check whether the totals can be used as they are.
+     * @param in_std_drink_size: The current standard drink size, in oz.
+     * @return: False if the store was never built, was invalidated, or was built for another standard drink size.
+     */
+
+    return valid && std_drink_size == in_std_drink_size;
+}
+
+void AggregateStore::add(const Drink &drink) {
+    /*
+     * Add a newly written drink to the totals. Does nothing until the store has been built.
+     */
+
+    if (valid) {
+        apply(drink.get_day(), drink.get_abv(), drink.get_size(), drink.get_ibu(), drink.get_alcohol_type(),
+              drink.get_producer(), drink.get_name(), drink.get_type(), 1);
+    }
+}
+
+void AggregateStore::remove(const Drink &drink) {
+    /*
+     * Remove a deleted drink from the totals. The drink must be the row as it was stored.
+     */
+
+    if (valid) {
+        apply(drink.get_day(), drink.get_abv(), drink.get_size(), drink.get_ibu(), drink.get_alcohol_type(),
+              drink.get_producer(), drink.get_name(), drink.get_type(), -1);
+    }
+}
+
+void AggregateStore::replace(const Drink &old_drink, const Drink &new_drink) {
+    /*
+     * Apply an update: remove the stored row and add its new values.
+     */
+
+    remove(old_drink);
+    add(new_drink);
+}
+
+StatsSnapshot AggregateStore::snapshot(const std::string &alcohol_type, const std::string &week_start,
+                                       const std::string &today) const {
+    /*
+     * Read the stats panel values from the totals. Matches the separate Calculate functions: favorite_*, mean_abv,
+     * mean_ibu and streaks.
+     * @param alcohol_type: The alcohol type for favorites and means, i.e. the current tab.
+     * @param week_start: First date of the week, YYYY-MM-DD.
+     * @param today: Today's date, YYYY-MM-DD.
+     * @return: The panel values. rows_scanned is left at 0, since nothing is read from the database.
+     */
+
+    StatsSnapshot stats;
+    const int today_day {civil_date::from_iso(today)};
+
+    for (auto day = days.lower_bound(civil_date::from_iso(week_start)); day != days.end(); ++day) {
+        stats.std_drinks_this_week += day->second.std_drinks;
+        stats.alcohol_volume_this_week += day->second.alcohol_volume;
+        if (day->first >= today_day) {
+            stats.std_drinks_today += day->second.std_drinks;
+        }
+    }
+
+    if (const auto totals = types.find(alcohol_type); totals != types.end()) {
+        stats.top_producers = Calculate::top_k(totals->second.producer_counts, StatsEngine::top_count);
+        stats.top_drinks = Calculate::top_k(totals->second.name_counts, StatsEngine::top_count);
+        stats.top_types = Calculate::top_k(totals->second.type_counts, StatsEngine::top_count);
+        stats.mean_abv = utilities::round_to_two_decimal_points(totals->second.abv_sum / totals->second.drinks);
+        stats.mean_ibu = totals->second.ibu_count ? totals->second.ibu_sum / totals->second.ibu_count : std::nan("");
+    } else {
+        stats.mean_abv = std::nan("");
+        stats.mean_ibu = std::nan("");
+    }
+    stats.favorite_producer = stats.top_producers.empty() ? "" : stats.top_producers.front().value;
+    stats.favorite_drink = stats.top_drinks.empty() ? "" : stats.top_drinks.front().value;
+    stats.favorite_type = stats.top_types.empty() ? "" : stats.top_types.front().value;
+
+    stats.streaks = streaks(today_day);
+
+    return stats;
+}
+
+Streaks AggregateStore::streaks(const int today) const {
+    /*
+     * Get the drinking and dry streaks. Walking the days is only redone when the set of days with drinks has
+     * changed, i.e. a day got its first drink or lost its last, or when the date has moved on.
+     * @param today: Today's day number.
+     */
+
+    if (streaks_stale || streaks_today != today) {
+        std::vector<int> drink_days;
+        drink_days.reserve(days.size());
+        for (const auto &day : days) {
+            drink_days.push_back(day.first);
+        }
+        cached_streaks = Calculate::streaks(drink_days, today);
+        streaks_today = today;
+        streaks_stale = false;
+    }
+    return cached_streaks;
+}
+
+std::size_t AggregateStore::size() const {
+    /*
+     * @return: The number of drinks in the totals.
+     */
+
+    return static_cast<std::size_t>(drink_count);
+}
+
+void AggregateStore::apply(const int day, const double abv, const double size, const double ibu,
+                           const std::string &alcohol_type, const std::string &producer, const std::string &name,
+                           const std::string &type, const int sign) {
+    /*
+     * Add (sign 1) or subtract (sign -1) one drink. Days and types with no drinks left are dropped, so they don't
+     * show up in streaks or favorites.
+     */
+
+    const double alcohol_volume {(abv/100)*size};
+    // Round per drink, like Drink::get_standard_drinks
+    const double std_drinks {utilities::round_to_two_decimal_points(alcohol_volume / std_drink_size)};
+
+    const auto [day_entry, new_day] = days.try_emplace(day);
+    DayTotals &day_totals = day_entry->second;
+    day_totals.drinks += sign;
+    day_totals.std_drinks += sign * std_drinks;
+    day_totals.alcohol_volume += sign * alcohol_volume;
+    if (day_totals.drinks <= 0) {
+        days.erase(day_entry);
+        streaks_stale = true;
+    } else if (new_day) {
+        streaks_stale = true;
+    }
+
+    TypeTotals &type_totals = types[alcohol_type];
+    type_totals.drinks += sign;
+    type_totals.abv_sum += sign * abv;
+    if (ibu > 0) {  // Ignore empty IBU values
+        type_totals.ibu_sum += sign * ibu;
+        type_totals.ibu_count += sign;
+    }
+    count(type_totals.producer_counts, producer, sign);
+    count(type_totals.name_counts, name, sign);
+    count(type_totals.type_counts, type, sign);
+    if (type_totals.drinks <= 0) {
+        types.erase(alcohol_type);
+    }
+
+    drink_count += sign;
+}
+
+void AggregateStore::count(std::unordered_map<std::string, int> &counts, const std::string &value, const int sign) {
+    const auto [entry, inserted] = counts.try_emplace(value, 0);
+    entry->second += sign;
+    if (entry->second <= 0) {
+        counts.erase(entry);
+    }
+}
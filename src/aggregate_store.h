@@ -0,0 +1,67 @@
+#ifndef BUZZBOT_AGGREGATE_STORE_H
+#define BUZZBOT_AGGREGATE_STORE_H
+
+#include "database.h"
+#include "stats_engine.h"
+#include <cstddef>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct DayTotals {
+    int drinks {0};
+    double std_drinks {0.0};
+    double alcohol_volume {0.0};  // oz
+};
+
+struct TypeTotals {
+    int drinks {0};
+    double abv_sum {0.0};
+    double ibu_sum {0.0};  // Only drinks with an IBU
+    int ibu_count {0};
+    std::unordered_map<std::string, int> producer_counts;
+    std::unordered_map<std::string, int> name_counts;
+    std::unordered_map<std::string, int> type_counts;
+};
+
+class AggregateStore {
+    /*
+     * Running totals behind the stats panel: standard drinks and alcohol volume per day, and counts and ABV/IBU sums
+     * per alcohol type. Built once with one scan of the drinks table, then kept current by applying each insert,
+     * update and delete as a delta. A rebuild is only needed when the store is invalidated, e.g. after an import, or
+     * when the standard drink size changes, since per-day standard drinks depend on it.
+     */
+
+public:
+    void rebuild(Storage &storage, const double &in_std_drink_size);
+    void invalidate();
+    [[nodiscard]] bool valid_for(const double &in_std_drink_size) const;
+
+    void add(const Drink &drink);
+    void remove(const Drink &drink);
+    void replace(const Drink &old_drink, const Drink &new_drink);
+
+    [[nodiscard]] StatsSnapshot snapshot(const std::string &alcohol_type, const std::string &week_start,
+                                         const std::string &today) const;
+    [[nodiscard]] std::size_t size() const;
+
+private:
+    bool valid {false};
+    double std_drink_size {0.0};
+    int drink_count {0};
+    std::map<int, DayTotals> days;  // Ordered, so a week is a short range scan
+    std::unordered_map<std::string, TypeTotals> types;
+    // Streaks only change when a day gains its first drink or loses its last, so they're kept between snapshots
+    mutable Streaks cached_streaks;
+    mutable int streaks_today {0};
+    mutable bool streaks_stale {true};
+
+    [[nodiscard]] Streaks streaks(int today) const;
+    void apply(int day, double abv, double size, double ibu, const std::string &alcohol_type,
+               const std::string &producer, const std::string &name, const std::string &type, int sign);
+    static void count(std::unordered_map<std::string, int> &counts, const std::string &value, int sign);
+};
+
+
+#endif //BUZZBOT_AGGREGATE_STORE_H
@@ -8,7 +8,17 @@
 
 void MainWindow::update_beer_fields() {
     /*
-     * Read rows in the DB and populate the brewery, type, and name dropdowns with unique values.
+     * Read the beers in the DB and populate the beer dropdowns from them.
+     */
+
+    update_beer_fields(Database::filter("Alcohol Type", "Beer", storage));
+}
+
+void MainWindow::update_beer_fields(std::vector<Drink> all_beers) {
+    /*
+     * Populate the brewery, type, and name dropdowns with unique values.
+     * @param all_beers: Beer drinks with at least their names, types, subtypes and producers. Passed in so one
+     * read can serve all three tabs.
      */
 
     std::set<QString> breweries;
@@ -16,7 +26,6 @@ void MainWindow::update_beer_fields() {
     std::set<QString> subtypes;
     std::set<std::string> names;
     std::vector<std::string> names_tmp;
-    std::vector<Drink> all_beers = Database::filter("Alcohol Type", "Beer", storage);
 
     // Block signals to avoid crashing
     QSignalBlocker brewery_signal_blocker(ui->beerBreweryInput);
@@ -4,10 +4,11 @@
 
 #include "calculate.h"
 #include "utilities.h"
+#include "civil_date.h"
 #include <cmath>
-#include <ctime>
 #include <iostream>
 #include <algorithm>
+#include <limits>
 
 using namespace sqlite_orm;
 
@@ -55,75 +56,73 @@ double Calculate::volume_alcohol_remaining(const Options& options, const double
     return utilities::round_to_two_decimal_points(vol_alcohol_remaining);
 }
 
-std::string Calculate::favorite_producer(const Storage& storage, const std::string& drink_type) {
+std::vector<ValueCount> Calculate::top_k(Storage &storage, const DrinkColumn column, const std::string& drink_type,
+                                         const int k) {
     /*
-     * Get the number of time each brewery appears in the database.
+     * Find the most common values of a column, e.g. the top 5 producers.
      * @param storage: A Storage instance.
-     * @return favorite_producer: The brewery that appears most often.
+     * @param column: The column to count.
+     * @param drink_type: The alcohol type to count.
+     * @param k: The number of values to return.
+     * @return: Up to k values with their counts, most common first. Ties are ordered alphabetically.
      */
 
-    std::map<std::string, unsigned> producer_counts;
-    std::vector<std::string> producers;
-    std::string favorite_producer;
+    return DrinkQuery().alcohol_type(drink_type).top_values(storage, column, k);
+}
 
-    //std::vector<Drink> all_drinks = storage.get_all<Drink>();
-    const std::vector<Drink> all_drinks = Database::filter("Alcohol Type", drink_type, storage);
+std::vector<ValueCount> Calculate::top_k(const std::unordered_map<std::string, int> &counts, const int k) {
+    /*
+     * Find the k most common values in counts already held in memory. Ties are ordered alphabetically, as
+     * DrinkQuery::top_values orders them.
+     * @param counts: Number of times each value appears.
+     * @param k: The number of values to return.
+     * @return: Up to k values with their counts, most common first.
+     */
 
-    producers.reserve(all_drinks.size());
-    for (const auto& drink: all_drinks) {
-        producers.push_back(drink.producer);
-    }
-    for (const auto& producer : producers) {
-        int producer_count = std::count(producers.begin(), producers.end(), producer);
-        producer_counts[producer] = producer_count;
+    using Count = std::pair<const std::string, int>;
+    std::vector<const Count *> ranked;
+    ranked.reserve(counts.size());
+    for (const auto &count : counts) {
+        ranked.push_back(&count);
     }
 
-    unsigned current_max = 0;
-    for (const auto & brewery_count : producer_counts) {
-        if (const unsigned second_count {brewery_count.second}; second_count > current_max) {
-            favorite_producer = brewery_count.first;
-            current_max = second_count;
-        }
+    const auto top_end = ranked.begin() + std::min(static_cast<std::ptrdiff_t>(std::max(k, 0)),
+                                                   static_cast<std::ptrdiff_t>(ranked.size()));
+    std::partial_sort(ranked.begin(), top_end, ranked.end(), [](const Count *lhs, const Count *rhs) {
+        return lhs->second != rhs->second ? lhs->second > rhs->second : lhs->first < rhs->first;
+    });
+
+    std::vector<ValueCount> top;
+    top.reserve(static_cast<std::size_t>(top_end - ranked.begin()));
+    for (auto count = ranked.begin(); count != top_end; ++count) {
+        top.push_back({(*count)->first, (*count)->second});
     }
+    return top;
+}
+
+std::string Calculate::favorite_producer(Storage &storage, const std::string& drink_type) {
+    /*
+     * Get the producer that appears most often.
+     * @param storage: A Storage instance.
+     * @return favorite_producer: The brewery that appears most often.
+     */
 
-    return favorite_producer;
+    const std::vector<ValueCount> top_producer {top_k(storage, DrinkColumn::Producer, drink_type, 1)};
+    return top_producer.empty() ? "" : top_producer.front().value;
 }
 
-std::string Calculate::favorite_drink(const Storage& storage, const std::string& drink_type) {
+std::string Calculate::favorite_drink(Storage &storage, const std::string& drink_type) {
     /*
      * Calculates favorite drink based on most common drink in database
      * @param Storage: a Storage instance
      * @return favorite_drink: The most common drink in the database.
      */
 
-    std::map<std::string, unsigned> drink_counts;
-    std::vector<std::string> drinks;
-    std::string favorite_drink;
-
-    const std::vector<Drink> all_drinks = Database::filter("Alcohol Type", drink_type, storage);
-
-    drinks.reserve(all_drinks.size());
-    for (const auto& drink: all_drinks) {
-        drinks.push_back(drink.name);
-    }
-    for (const auto& producer : drinks) {
-        int producer_count = std::count(drinks.begin(), drinks.end(), producer);
-        drink_counts[producer] = producer_count;
-    }
-
-    unsigned current_max = 0;
-
-    for (const auto & producer_count : drink_counts) {
-        if (const unsigned second_count {producer_count.second}; second_count > current_max) {
-            favorite_drink = producer_count.first;
-            current_max = second_count;
-        }
-    }
-
-    return favorite_drink;
+    const std::vector<ValueCount> top_drink {top_k(storage, DrinkColumn::Name, drink_type, 1)};
+    return top_drink.empty() ? "" : top_drink.front().value;
 }
 
-double Calculate::mean_abv(const Storage& storage, const std::string& drink_type) {
+double Calculate::mean_abv(Storage &storage, const std::string& drink_type) {
     /*
      * Calculate the mean ABV for all drinks.
      * @param storage: A storage instance.
@@ -132,17 +131,15 @@ double Calculate::mean_abv(const Storage& storage, const std::string& drink_type
 
     double abv_sum = 0.0;
     unsigned drink_count = 0;
-    const std::vector<Drink> all_drinks = Database::filter("Alcohol Type", drink_type, storage);
-
-    for (const auto& drink : all_drinks) {
+    DrinkQuery().alcohol_type(drink_type).columns({DrinkColumn::Abv}).for_each(storage, [&](const Drink &drink) {
         drink_count += 1;
         abv_sum += drink.abv;
-    }
+    });
 
     return utilities::round_to_two_decimal_points(abv_sum / drink_count);
 }
 
-double Calculate::mean_ibu(const Storage& storage, const std::string& drink_type) {
+double Calculate::mean_ibu(Storage &storage, const std::string& drink_type) {
     /*
      * Calculate the mean IBU of all drinks in the database.
      * @param storage: A storage instance.
@@ -151,51 +148,26 @@ double Calculate::mean_ibu(const Storage& storage, const std::string& drink_type
 
     double ibu_sum = 0.0;
     unsigned drink_count = 0;
-    const std::vector<Drink> all_drinks = Database::filter("Alcohol Type", drink_type, storage);
-
-    for (const auto& drink : all_drinks) {
+    DrinkQuery().alcohol_type(drink_type).columns({DrinkColumn::Ibu}).for_each(storage, [&](const Drink &drink) {
         // Ignore empty IBU values
         if (drink.ibu > 0) {
             drink_count += 1;
+            ibu_sum += drink.ibu;
         }
-        ibu_sum += drink.ibu;
-    }
+    });
 
     return ibu_sum / drink_count;
 }
 
-std::string Calculate::favorite_type(const Storage& storage, const std::string& drink_type) {
+std::string Calculate::favorite_type(Storage &storage, const std::string& drink_type) {
     /*
      * Calculates favorite drink type based on most common type in database
      * @param Storage: a Storage instance
      * @return favorite_type: The most common type in the database.
      */
 
-    std::map<std::string, unsigned> type_counts;
-    std::vector<std::string> types;
-    std::string favorite_type;
-
-    const std::vector<Drink> all_drinks = Database::filter("Alcohol Type", drink_type, storage);
-
-    types.reserve(all_drinks.size());
-    for (const auto& drink: all_drinks) {
-        types.push_back(drink.type);
-    }
-    for (const auto& type : types) {
-        int producer_count = std::count(types.begin(), types.end(), type);
-        type_counts[type] = producer_count;
-    }
-
-    unsigned current_max = 0;
-
-    for (const auto & type_count : type_counts) {
-        if (const unsigned second_count {type_count.second}; second_count > current_max) {
-            favorite_type = type_count.first;
-            current_max = second_count;
-        }
-    }
-
-    return favorite_type;
+    const std::vector<ValueCount> top_type {top_k(storage, DrinkColumn::Type, drink_type, 1)};
+    return top_type.empty() ? "" : top_type.front().value;
 }
 
 std::string Calculate::double_to_string(const double &input_double) {
@@ -279,65 +251,66 @@ int Calculate::days_in_row(Storage &storage) {
     /*
      * Calculates the number of days in a row one has consumed alcohol.
      * @param storage: a storage object
-     * @param date: today's date
      */
 
-    bool found_day_without_drink {false};
-    int day_counter {0};
-    const std::string date {utilities::get_local_date()};
-
-    // Construct the initial date
-    std::tm search_date{};
-    search_date.tm_year = std::stoi(date.substr(0, 4)) - 1900;  // tm takes year - 1900
-    search_date.tm_mon = std::stoi(date.substr(5, 7)) - 1;  // tm month is 0-indexed
-    search_date.tm_mday = std::stoi(date.substr(8, 9));
-
-    decrement_day(search_date);
-
-    std::string prev_day {std::to_string(search_date.tm_year + 1900) + '-'
-                          + utilities::zero_pad_string(search_date.tm_mon + 1) + '-' +
-                          utilities::zero_pad_string(search_date.tm_mday)};
-
-    bool scanned_today {false};
-    bool scanned_yesterday {false};
-    while (!found_day_without_drink) {
-        if (!scanned_today && !storage.get_all<Drink>(where(c(&Drink::date) == date)).empty()) {
-            day_counter ++;
-            scanned_today = true;
-        } else if (!scanned_today) {
-            scanned_today = true;
-        }
-        if (!scanned_yesterday && storage.get_all<Drink>(where(c(&Drink::date) == prev_day)).empty()) {
-            found_day_without_drink = true;
-        } else {
-            if (!scanned_yesterday) {
-                scanned_yesterday = true;
-            }
-            day_counter ++;
-            decrement_day(search_date);
-            prev_day = std::to_string(search_date.tm_year + 1900) + '-' + utilities::zero_pad_string(search_date.tm_mon + 1) + '-'
-                       + utilities::zero_pad_string(search_date.tm_mday);
-
-            if (storage.get_all<Drink>(where(c(&Drink::date) == prev_day)).empty()) {
-                found_day_without_drink = true;
-            }
+    return streaks(storage, utilities::get_local_date()).current;
+}
+
+Streaks Calculate::streaks(Storage &storage, const std::string& today) {
+    /*
+     * Calculate drinking and dry streaks from the days with drinks, read from daily_totals.
+     * @param storage: a storage object
+     * @param today: today's date, YYYY-MM-DD
+     */
+
+    const int today_day {civil_date::from_iso(today)};
+    std::vector<int> days;
+    for (const auto &total : Database::daily_totals(storage, std::numeric_limits<int>::min(), today_day)) {
+        if (days.empty() || days.back() != total.day) {  // One row per alcohol type
+            days.push_back(total.day);
         }
     }
-    return day_counter;
+    return streaks(days, today_day);
 }
 
-void Calculate::decrement_day(std::tm &date) {
-    /* Decrements a time object by a day
-     * @param date: a tm object
+Streaks Calculate::streaks(const std::vector<int> &days, const int today) {
+    /*
+     * Calculate drinking and dry streaks in one pass over the days with drinks. Days after today are ignored, and dry
+     * days are only counted after the first drink.
+     * @param days: Distinct day numbers with at least one drink, in ascending order.
+     * @param today: Today's day number.
      */
 
-    std::time_t search_date_t {std::mktime(&date)};
-    search_date_t -= 60*60*24;
-    const std::tm *search_date {std::localtime(&search_date_t)};
+    Streaks streaks;
+    int run {0};
+    int previous_day {0};
+    bool first_day {true};
+
+    for (const int day : days) {
+        if (day > today) {
+            break;
+        }
+        if (first_day || day != previous_day + 1) {
+            run = 0;
+        }
+        if (!first_day) {
+            streaks.longest_dry = std::max(streaks.longest_dry, day - previous_day - 1);
+        }
+        run++;
+        streaks.longest = std::max(streaks.longest, run);
+        previous_day = day;
+        first_day = false;
+    }
+
+    if (!first_day) {
+        if (previous_day >= today - 1) {
+            streaks.current = run;  // Through today, or through yesterday with nothing yet today
+        }
+        streaks.current_dry = today - previous_day;
+        streaks.longest_dry = std::max(streaks.longest_dry, streaks.current_dry);
+    }
 
-    date.tm_year = search_date->tm_year;
-    date.tm_mon = search_date->tm_mon;
-    date.tm_mday = search_date->tm_mday;
+    return streaks;
 }
 
 bool Calculate::equal_double(const double a, const double b) {
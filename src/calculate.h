@@ -6,30 +6,40 @@
 #define BEERTABS_CALCULATE_H
 
 #include <string>
+#include <unordered_map>
 #include "database.h"
+#include "drink_query.h"
 #include "options.h"
 
+struct Streaks {
+    int current {0};  // Consecutive days with drinks up to today, counting today only if there were drinks today
+    int longest {0};
+    int current_dry {0};  // Days without drinks since the last drink, including today
+    int longest_dry {0};
+};
+
 class Calculate {
 public:
     static double alcohol_volume(const double &abv, const double &amount);
     static double standard_drinks(const double &abv, const double &amount, const double &std_drink_size);
     static double standard_drinks_remaining(const Options& options, const double &standard_drinks_consumed);
     static double volume_alcohol_remaining(const Options& options, const double &volume_consumed);
-    static std::string favorite_producer(const Storage& storage, const std::string& drink_type);
-    static std::string favorite_drink(const Storage& storage, const std::string& drink_type);
-    static std::string favorite_type(const Storage& storage, const std::string& drink_type);
-    static double mean_abv(const Storage& storage, const std::string& drink_type);
-    static double mean_ibu(const Storage& storage, const std::string& drink_type);
+    static std::vector<ValueCount> top_k(Storage &storage, DrinkColumn column, const std::string& drink_type, int k);
+    static std::vector<ValueCount> top_k(const std::unordered_map<std::string, int> &counts, int k);
+    static std::string favorite_producer(Storage &storage, const std::string& drink_type);
+    static std::string favorite_drink(Storage &storage, const std::string& drink_type);
+    static std::string favorite_type(Storage &storage, const std::string& drink_type);
+    static double mean_abv(Storage &storage, const std::string& drink_type);
+    static double mean_ibu(Storage &storage, const std::string& drink_type);
     static std::string double_to_string(const double &input_double);
     static double oz_to_ml(const double &input_oz);
     static double ml_to_oz(const double &input_ml);
     static bool compare_strings(std::string lhs, std::string rhs);
     static int weekly_limit(const Options& options);
     static int days_in_row(Storage &storage);
+    static Streaks streaks(Storage &storage, const std::string& today);
+    static Streaks streaks(const std::vector<int> &days, int today);
     static bool equal_double(const double a, const double b);
-
-private:
-    static void decrement_day(std::tm &date);
 };
 
 
@@ -0,0 +1,246 @@
+#ifndef BUZZBOT_CIVIL_DATE_H
+#define BUZZBOT_CIVIL_DATE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+struct YearMonthDay {
+    int year;
+    unsigned month;
+    unsigned day;
+};
+
+struct IsoWeek {
+    int year;
+    unsigned week;  // 1-53
+};
+
+class civil_date {
+    /*
+     * Allocation-free, constexpr calendar arithmetic on day numbers (days since 1970-01-01). Dates are civil dates,
+     * so nothing here depends on the time zone or locale. Weekdays use the C encoding: 0 is Sunday, 6 is Saturday.
+     */
+
+public:
+    static constexpr unsigned sunday {0};
+    static constexpr unsigned monday {1};
+    static constexpr int seconds_per_day {86400};
+
+    static constexpr int days_from_civil(int year, const unsigned month, const unsigned day) {
+        /*
+         * Convert a proleptic Gregorian date to a day number, counted from 1970-01-01. Matches
+         * julianday(date) - julianday('1970-01-01') in SQLite.
+         * @param year: Calendar year.
+         * @param month: Month, 1-12.
+         * @param day: Day of month, 1-31.
+         * @return: Days since 1970-01-01. Negative for earlier dates.
+         */
+
+        year -= month <= 2;
+        const int era {(year >= 0 ? year : year - 399) / 400};
+        const auto year_of_era {static_cast<unsigned>(year - era * 400)};
+        const unsigned day_of_year {(153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1};
+        const unsigned day_of_era {year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year};
+        return era * 146097 + static_cast<int>(day_of_era) - 719468;
+    }
+
+    static constexpr YearMonthDay civil_from_days(int day_number) {
+        /*
+         * Convert a day number back to a proleptic Gregorian date. Inverse of days_from_civil.
+         * @param day_number: Days since 1970-01-01.
+         * @return: The calendar date.
+         */
+
+        day_number += 719468;
+        const int era {(day_number >= 0 ? day_number : day_number - 146096) / 146097};
+        const auto day_of_era {static_cast<unsigned>(day_number - era * 146097)};
+        const unsigned year_of_era {(day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365};
+        const unsigned day_of_year {day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100)};
+        const unsigned shifted_month {(5 * day_of_year + 2) / 153};
+        const unsigned day {day_of_year - (153 * shifted_month + 2) / 5 + 1};
+        const unsigned month {shifted_month < 10 ? shifted_month + 3 : shifted_month - 9};
+        const int year {static_cast<int>(year_of_era) + era * 400 + (month <= 2)};
+        return {year, month, day};
+    }
+
+    static constexpr int to_yyyymmdd(const int day_number) {
+        /*
+         * Convert a day number to an integer date such as 20210405.
+         */
+
+        const YearMonthDay date {civil_from_days(day_number)};
+        return date.year * 10000 + static_cast<int>(date.month) * 100 + static_cast<int>(date.day);
+    }
+
+    static constexpr int from_iso(const char *date, const std::size_t length) {
+        /*
+         * Convert a YYYY-MM-DD date to a day number without allocating or calling stoi.
+         * @param date: Characters of the date.
+         * @param length: Number of characters.
+         * @return: Days since 1970-01-01, or 0 if the text isn't a YYYY-MM-DD date.
+         */
+
+        if (length < 10 || date[4] != '-' || date[7] != '-') {
+            return 0;
+        }
+        for (const std::size_t i : {0, 1, 2, 3, 5, 6, 8, 9}) {
+            if (date[i] < '0' || date[i] > '9') {
+                return 0;
+            }
+        }
+
+        const int year {(date[0] - '0') * 1000 + (date[1] - '0') * 100 + (date[2] - '0') * 10 + (date[3] - '0')};
+        const auto month {static_cast<unsigned>((date[5] - '0') * 10 + (date[6] - '0'))};
+        const auto day {static_cast<unsigned>((date[8] - '0') * 10 + (date[9] - '0'))};
+        if (month < 1 || month > 12 || day < 1 || day > 31) {
+            return 0;
+        }
+        return days_from_civil(year, month, day);
+    }
+
+    static int from_iso(const std::string &date) {
+        return from_iso(date.data(), date.size());
+    }
+
+    static constexpr int from_yyyymmdd(const int yyyymmdd) {
+        /*
+         * Convert an integer date such as 20210405 to a day number. Inverse of to_yyyymmdd.
+         */
+
+        return days_from_civil(yyyymmdd / 10000, static_cast<unsigned>(yyyymmdd / 100 % 100),
+                               static_cast<unsigned>(yyyymmdd % 100));
+    }
+
+    static std::string to_iso(const int day_number) {
+        /*
+         * Convert a day number to a YYYY-MM-DD date, for years 0-9999.
+         */
+
+        const YearMonthDay date {civil_from_days(day_number)};
+        const auto year {static_cast<unsigned>(date.year)};
+        return {static_cast<char>('0' + year / 1000 % 10), static_cast<char>('0' + year / 100 % 10),
+                static_cast<char>('0' + year / 10 % 10), static_cast<char>('0' + year % 10), '-',
+                static_cast<char>('0' + date.month / 10), static_cast<char>('0' + date.month % 10), '-',
+                static_cast<char>('0' + date.day / 10), static_cast<char>('0' + date.day % 10)};
+    }
+
+    static constexpr long long to_epoch_seconds(const int day_number) {
+        /*
+         * Seconds since the epoch at midnight UTC of a day, e.g. for a date axis in UTC.
+         */
+
+        return static_cast<long long>(day_number) * seconds_per_day;
+    }
+
+    static constexpr unsigned weekday(const int day_number) {
+        /*
+         * Day of the week, 0 (Sunday) to 6 (Saturday). 1970-01-01 was a Thursday.
+         */
+
+        return static_cast<unsigned>(day_number >= -4 ? (day_number + 4) % 7 : (day_number + 5) % 7 + 6);
+    }
+
+    static constexpr unsigned iso_weekday(const int day_number) {
+        /*
+         * Day of the week, 1 (Monday) to 7 (Sunday).
+         */
+
+        const unsigned day {weekday(day_number)};
+        return day == sunday ? 7 : day;
+    }
+
+    static constexpr int day_of_year(const int day_number) {
+        /*
+         * Days since January 1st of the same year, 0-365.
+         */
+
+        return day_number - days_from_civil(civil_from_days(day_number).year, 1, 1);
+    }
+
+    static constexpr int week_start(const int day_number, const unsigned first_weekday) {
+        /*
+         * Find the first day of the week containing a day.
+         * @param day_number: A day in the week.
+         * @param first_weekday: The day weeks start on, 0 (Sunday) to 6 (Saturday).
+         * @return: The day number of the latest first_weekday on or before day_number.
+         */
+
+        return day_number - static_cast<int>((weekday(day_number) + 7 - first_weekday % 7) % 7);
+    }
+
+    static constexpr int monday_week_number(const int day_number) {
+        /*
+         * Week of the year with weeks starting on Monday, as strftime's %W. Days before the year's first Monday are
+         * in week 0.
+         */
+
+        return (day_of_year(day_number) + 7 - static_cast<int>(iso_weekday(day_number)) + 1) / 7;
+    }
+
+    static constexpr int from_monday_week(const int year, const int week) {
+        /*
+         * Find the Monday of a %W week. Inverse of monday_week_number. The Monday of week 0 may fall in the previous
+         * year.
+         * @param year: Calendar year.
+         * @param week: Week number, 0-53.
+         * @return: The day number of the Monday.
+         */
+
+        const int january_first {days_from_civil(year, 1, 1)};
+        const int first_monday {january_first + static_cast<int>((8 - iso_weekday(january_first)) % 7)};
+        return first_monday + (week - 1) * 7;
+    }
+
+    static constexpr IsoWeek iso_week(const int day_number) {
+        /*
+         * ISO 8601 week: weeks start on Monday, and week 1 contains the year's first Thursday. Days near the start or
+         * end of a year can belong to a week of the neighbouring year.
+         */
+
+        const int thursday {day_number - static_cast<int>(iso_weekday(day_number)) + 4};
+        const int year {civil_from_days(thursday).year};
+        return {year, static_cast<unsigned>(day_of_year(thursday) / 7 + 1)};
+    }
+
+    static constexpr unsigned weekday_from_name(const std::string_view name) {
+        /*
+         * Convert an English weekday name, as stored in Options::weekday_start, to a weekday. Unknown names are
+         * Sunday.
+         */
+
+        constexpr std::string_view names[] {"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday",
+                                            "Saturday"};
+        for (unsigned day = 0; day < 7; day++) {
+            if (names[day] == name) {
+                return day;
+            }
+        }
+        return sunday;
+    }
+
+    static constexpr std::string_view weekday_name(const unsigned day) {
+        /*
+         * English name of a weekday, 0 (Sunday) to 6 (Saturday).
+         */
+
+        constexpr std::string_view names[] {"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday",
+                                            "Saturday"};
+        return names[day % 7];
+    }
+};
+
+static_assert(civil_date::days_from_civil(1970, 1, 1) == 0);
+static_assert(civil_date::days_from_civil(2000, 3, 1) == 11017);
+static_assert(civil_date::from_iso("2020-09-08", 10) == 18513);
+static_assert(civil_date::to_yyyymmdd(18513) == 20200908);
+static_assert(civil_date::to_yyyymmdd(-1) == 19691231);
+static_assert(civil_date::from_yyyymmdd(20200908) == 18513);
+static_assert(civil_date::weekday(0) == 4);  // Thursday
+static_assert(civil_date::weekday(-5) == 6);  // 1969-12-27, a Saturday
+static_assert(civil_date::iso_week(civil_date::days_from_civil(2021, 1, 1)).year == 2020);
+static_assert(civil_date::iso_week(civil_date::days_from_civil(2021, 1, 1)).week == 53);
+static_assert(civil_date::week_start(18513, civil_date::monday) == 18512);  // 2020-09-08 was a Tuesday
+static_assert(civil_date::weekday_from_name("Friday") == 5);
+
+#endif //BUZZBOT_CIVIL_DATE_H
@@ -1,55 +1,124 @@
 #include "database.h"
 #include "utilities.h"
+#include "drink_query.h"
+#include "sqlite_statement.h"
+#include <algorithm>
 #include <utility>
 #include <iostream>
 #include <filesystem>
+#include <stdexcept>
 #include <string>
 
 using namespace sqlite_orm;
 
-std::vector<Drink> Database::read(Storage storage) {
+namespace {
+    // Standard drinks depend on the user's standard drink size, so daily_totals keeps the oz of alcohol instead
+    const char *const daily_totals_schema {
+        "CREATE TABLE IF NOT EXISTS daily_totals ("
+        "    day INTEGER NOT NULL,"
+        "    alcohol_type TEXT NOT NULL,"
+        "    alcohol_volume REAL NOT NULL DEFAULT 0,"
+        "    drinks INTEGER NOT NULL DEFAULT 0,"
+        "    PRIMARY KEY (day, alcohol_type)"
+        ") WITHOUT ROWID;"
+        "CREATE TRIGGER IF NOT EXISTS daily_totals_insert AFTER INSERT ON drinks BEGIN"
+        "    INSERT OR IGNORE INTO daily_totals (day, alcohol_type) VALUES (NEW.day, NEW.alcohol_type);"
+        "    UPDATE daily_totals SET alcohol_volume = alcohol_volume + NEW.abv / 100.0 * NEW._size, drinks = drinks + 1"
+        "        WHERE day = NEW.day AND alcohol_type = NEW.alcohol_type;"
+        "END;"
+        "CREATE TRIGGER IF NOT EXISTS daily_totals_delete AFTER DELETE ON drinks BEGIN"
+        "    UPDATE daily_totals SET alcohol_volume = alcohol_volume - OLD.abv / 100.0 * OLD._size, drinks = drinks - 1"
+        "        WHERE day = OLD.day AND alcohol_type = OLD.alcohol_type;"
+        "    DELETE FROM daily_totals WHERE day = OLD.day AND alcohol_type = OLD.alcohol_type AND drinks <= 0;"
+        "END;"
+        "CREATE TRIGGER IF NOT EXISTS daily_totals_update AFTER UPDATE OF day, alcohol_type, abv, _size ON drinks BEGIN"
+        "    UPDATE daily_totals SET alcohol_volume = alcohol_volume - OLD.abv / 100.0 * OLD._size, drinks = drinks - 1"
+        "        WHERE day = OLD.day AND alcohol_type = OLD.alcohol_type;"
+        "    DELETE FROM daily_totals WHERE day = OLD.day AND alcohol_type = OLD.alcohol_type AND drinks <= 0;"
+        "    INSERT OR IGNORE INTO daily_totals (day, alcohol_type) VALUES (NEW.day, NEW.alcohol_type);"
+        "    UPDATE daily_totals SET alcohol_volume = alcohol_volume + NEW.abv / 100.0 * NEW._size, drinks = drinks + 1"
+        "        WHERE day = NEW.day AND alcohol_type = NEW.alcohol_type;"
+        "END;"
+    };
+
+    bool schema_has(sqlite3 *db, const char *sql) {
+        // Run a COUNT(*) on sqlite_master, true if it matches anything
+        const Statement statement {prepare_statement(db, sql)};
+        if (sqlite3_step(statement.get()) != SQLITE_ROW) {
+            throw std::runtime_error(std::string("Failed to read the schema: ") + sqlite3_errmsg(db));
+        }
+        return sqlite3_column_int(statement.get(), 0) > 0;
+    }
+
+    struct ConnectionAccess : Storage {
+        // sqlite_orm keeps get_connection protected. Naming it through a derived type lets Database run the few
+        // statements sqlite_orm has no API for without opening a second connection.
+        static internal::connection_ref get(Storage &storage) {
+            return (storage.*(&ConnectionAccess::get_connection))();
+        }
+    };
+}
+
+std::vector<Drink> Database::read(Storage &storage) {
     /*
      * Read all rows from the database.
      * @return all_drinks A vector containing Drink, storing all rows in the database.
      */
 
-    const std::vector<Drink> all_drinks = storage.get_all<Drink>();
+    const std::vector<Drink> all_drinks = storage.get_all<Drink>(multi_order_by(order_by(&Drink::day),
+                                                                                 order_by(&Drink::id)));
     std::cout << "Read " + std::to_string(all_drinks.size()) + " drinks from DB" << std::endl;
 
     return all_drinks;
 }
 
+void Database::for_each(Storage &storage, const std::function<void(const Drink &)> &visit) {
+    /*
+     * Stream every row of the database, in the same order as read(), without holding them all in memory. Use this
+     * instead of read() to process a whole log of any size.
+     * @param storage: A storage instance. The callback must not write to it.
+     * @param visit: Called once per drink. The drink is reused for the next row.
+     */
+
+    DrinkQuery().order_by_date().for_each(storage, visit);
+}
+
 void Database::write_db_to_disk(Storage &storage) {
     /*
-     * Flush in-memory database data to disk.
+     * Create or migrate the drinks table so it matches initStorage. If that rebuilt the table, the daily_totals
+     * triggers went with it, so they are put back. daily_totals itself is created by the version 11 migration, after
+     * the day column is filled. This inspects and possibly rewrites the schema, so it belongs in startup migration
+     * only, never in the per-drink write path.
      */
 
     storage.sync_schema(true);
+    auto db = connection(storage);
+    if (schema_has(db.get(), "SELECT COUNT(*) FROM sqlite_master WHERE type = 'table' AND name = 'daily_totals'")) {
+        create_daily_totals(storage);  // Only does anything if a trigger is missing
+    }
 }
 
-Storage Database::write(Drink drink, Storage storage) {
+int Database::write(Drink drink, Storage &storage) {
     /*
      * Write a row to the SQLite database.
      * @param drink: a drink
-     * @return Storage: The storage instance
+     * @param storage: The storage instance
+     * @return: The primary key of the inserted row.
      */
 
-    const std::string database_path = utilities::get_db_path();
     const int inserted_id = storage.insert(drink);
     drink.id = inserted_id;
-    write_db_to_disk(storage);
 
-    return storage;
+    return inserted_id;
 }
 
-void Database::truncate(Storage storage) {
+void Database::truncate(Storage &storage) {
     /*
      * Delete all rows from the sqlite database while retaining columns.
      * @param storage: a storage instance.
      */
 
     storage.remove_all<Drink>();
-    write_db_to_disk(storage);
 }
 
 void Database::delete_row(Storage &storage, const int &row_num) {
@@ -74,7 +143,7 @@ Drink Database::read_row(const int &row_num, Storage &storage) {
     return drink;
 }
 
-void Database::update(Storage storage, const Drink& drink) {
+void Database::update(Storage &storage, const Drink& drink) {
     /*
      * Update a specific database row.
      * @param storage: A storage instance.
@@ -109,46 +178,16 @@ std::string Database::get_latest_notes(Storage &storage, const std::string& name
 }
 
 
-std::vector<Drink> Database::filter(const std::string& filter_type, const std::string& filter_text, Storage storage) {
+std::vector<Drink> Database::filter(const std::string& filter_type, const std::string& filter_text, Storage &storage) {
     /*
      * Retrieve DB rows based on filter column and text.
      * @param filter_type: Column on which to filter.
      * @param filter_text: Text to search columns for.
      * @param storage: A storage instance.
-     * @return filtered_drinks: The results of the database query.
+     * @return: The results of the database query, ordered by date and then ID.
      */
 
-    std::vector<Drink> filtered_drinks;
-
-    // Filter by name
-    if (filter_type == "Name") {
-        filtered_drinks = storage.get_all<Drink>(where(c(&Drink::name) == filter_text));
-    } else if (filter_type == "Type") {
-        filtered_drinks = storage.get_all<Drink>(where(c(&Drink::type) == filter_text));
-    } else if (filter_type == "Subtype") {
-        filtered_drinks = storage.get_all<Drink>(where(c(&Drink::subtype) == filter_text));
-    } else if (filter_type == "Producer") {
-        filtered_drinks = storage.get_all<Drink>(where(c(&Drink::producer) == filter_text));
-    } else if (filter_type == "Alcohol Type") {
-        filtered_drinks = storage.get_all<Drink>(where(c(&Drink::alcohol_type) == filter_text));
-    } else if (filter_type == "After Date") {
-        std::cout << "Filter date: " << filter_text << std::endl;
-        filtered_drinks = storage.get_all<Drink>(where(c(&Drink::date) >= filter_text));
-
-    } else if (filter_type == "Rating") {
-        filtered_drinks = storage.get_all<Drink>(where(c(&Drink::rating) == filter_text));
-    } else if (filter_type == "Name & Producer") {
-        // Parse the -- (PRODUCER) text to strip out drink name and producer.
-        std::string producer_name {filter_text.substr(filter_text.find(" -- (") + 5)};
-        producer_name = producer_name.substr(0, producer_name.size() - 1);
-        const std::string drink_name {filter_text.substr(0, filter_text.find(" -- ("))};
-        std::cout << drink_name << " " << producer_name << std::endl;
-        filtered_drinks = storage.get_all<Drink>(where(c(&Drink::name) == drink_name and c(&Drink::producer) == producer_name));
-    } else {
-        filtered_drinks = storage.get_all<Drink>();
-    }
-
-    return filtered_drinks;
+    return DrinkQuery::from_filter(filter_type, filter_text).order_by_date().run(storage);
 }
 
 Drink Database::get_drink_by_name(Storage &storage, const std::string &alcohol_type, const std::string &drink_name) {
@@ -159,14 +198,13 @@ Drink Database::get_drink_by_name(Storage &storage, const std::string &alcohol_t
      * @return drink_by_name: A Drink matching the name.
      */
 
-    std::vector<Drink> drink_by_name_result = storage.get_all<Drink>(where(c(&Drink::name) ==
-            drink_name && c(&Drink::alcohol_type) == alcohol_type));
+    const std::vector<Drink> drink_by_name_result = storage.get_all<Drink>(where(c(&Drink::name) ==
+            drink_name && c(&Drink::alcohol_type) == alcohol_type),
+            multi_order_by(order_by(&Drink::day).desc(), order_by(&Drink::id).desc()), limit(1));
     Drink drink_by_name;
 
-    std::sort(drink_by_name_result.begin(), drink_by_name_result.end(), compare_date);
-
     if (!drink_by_name_result.empty()) {
-        drink_by_name = drink_by_name_result.at(drink_by_name_result.size() - 1);
+        drink_by_name = drink_by_name_result.front();
     } else {
         drink_by_name.id = -1;
     }
@@ -182,15 +220,14 @@ Drink Database::get_drink_by_name(Storage &storage, const std::string &alcohol_t
      * @param producer: The drink producer
      */
 
-    std::vector<Drink> drink_by_name_result = storage.get_all<Drink>(where(c(&Drink::name)
+    const std::vector<Drink> drink_by_name_result = storage.get_all<Drink>(where(c(&Drink::name)
             == drink_name && c(&Drink::alcohol_type) == alcohol_type &&
-            c(&Drink::producer) == producer));
+            c(&Drink::producer) == producer),
+            multi_order_by(order_by(&Drink::day).desc(), order_by(&Drink::id).desc()), limit(1));
     Drink drink_by_name;
 
-    std::sort(drink_by_name_result.begin(), drink_by_name_result.end(), compare_date);
-
     if (!drink_by_name_result.empty()) {
-        drink_by_name = drink_by_name_result.at(drink_by_name_result.size() - 1);
+        drink_by_name = drink_by_name_result.front();
     } else {
         drink_by_name.id = -1;
     }
@@ -220,7 +257,7 @@ std::vector<Drink> Database::get_drinks_by_producer(Storage &storage, std::strin
     return drinks_by_producer;
 }
 
-int Database::get_version(Storage storage) { // NOLINT(performance-unnecessary-value-param)
+int Database::get_version(Storage &storage) {
     /*
      * Get the current database version.
      * @param storage: A storage instance.
@@ -229,10 +266,11 @@ int Database::get_version(Storage storage) { // NOLINT(performance-unnecessary-v
     return storage.pragma.user_version();
 }
 
-int Database::increment_version(Storage storage, int current_version) {
+int Database::increment_version(Storage &storage, int current_version) {
     /*
      * Increment database version to current version. This is used to implement
-     * database changes in place across versions
+     * database changes in place across versions. The data migrations run in one savepoint, and the version is only
+     * set once they have committed, so a migration that fails is run again on the next start.
      * @param storage: A storage instance.
      * @param current_version: The version that the DB should be incremented to.
      * @return: An integer denoting new DB version, straight from the DB.
@@ -250,48 +288,160 @@ int Database::increment_version(Storage storage, int current_version) {
              * size column.*/
         }
     }
+    write_db_to_disk(storage);
+
+    bool indexes_changed {false};
+    if (version < 9 && current_version >= 9) {  // Version 9 adds the indexes declared in initStorage
+        indexes_changed = true;
+    }
+    const auto migration_connection = connection(storage);  // The savepoint only lasts while its connection is open
+    execute(storage, "SAVEPOINT migrate;");
+    try {
+        if (version < 10 && current_version >= 10) {  // Version 10 adds the integer day column, replacing the date index
+            std::cout << "*** Filling day column from dates" << std::endl;
+            execute(storage, "UPDATE drinks SET day = "
+                             "COALESCE(CAST(julianday(date) - julianday('1970-01-01') AS INTEGER), 0);"
+                             "DROP INDEX IF EXISTS idx_drinks_date;");
+            indexes_changed = true;
+        }
+        if (version < 11 && current_version >= 11) {  // Version 11 adds daily_totals, filled here and kept by triggers
+            std::cout << "*** Filling daily totals" << std::endl;
+            execute(storage, daily_totals_schema);
+            rebuild_daily_totals(storage);
+        }
+        execute(storage, "RELEASE migrate;");
+    } catch (const std::exception &error) {
+        std::cerr << "Migration to version " << current_version << " failed: " << error.what() << std::endl;
+        execute(storage, "ROLLBACK TO migrate; RELEASE migrate;");
+        throw;
+    }
+
     // Set to new version number
     storage.pragma.user_version(current_version);
-    storage.sync_schema(true);
+    if (indexes_changed) {
+        std::cout << "*** Gathering index statistics" << std::endl;
+        execute(storage, "ANALYZE");
+    }
 
     return storage.pragma.user_version();
 }
 
 bool Database::compare_date(const Drink &a, const Drink &b) {
     /*
-     * Determine if second date is greater than the first date.
+     * Determine if second date is greater than the first date. Drinks on the same date are ordered by ID.
      * @return: True if second date is more recent than the first date. Else, false.
      */
 
-    const int a_year = std::stoi(a.get_date().substr(0, 4));
-    const int a_month = std::stoi(a.get_date().substr(5, 7));
-    const int a_day = std::stoi(a.get_date().substr(8, 9));
-    const int b_year = std::stoi(b.get_date().substr(0, 4));
-    const int b_month = std::stoi(b.get_date().substr(5, 7));
-    const int b_day = std::stoi(b.get_date().substr(8, 9));
-
-    if (a_year < b_year) {
-        return true;
-    } else if (a_year == b_year) {
-        if (a_month < b_month) {
-            return true;
-        } else if (a_month == b_month && a_day < b_day) {
-            return true;
-        } else if (a_month == b_month && a_day == b_day && a.id < b.id) {
-            return true;
-        }
+    return a.day < b.day || (a.day == b.day && a.id < b.id);
+}
+
+void Database::execute(Storage &storage, const std::string &sql) {
+    /*
+     * Run a raw SQL statement that sqlite_orm has no API for, such as ANALYZE. Used by migrations only.
+     * @param storage: A storage instance.
+     * @param sql: The statement(s) to execute.
+     */
+
+    auto db = connection(storage);
+    char *error_message {nullptr};
+    if (sqlite3_exec(db.get(), sql.c_str(), nullptr, nullptr, &error_message) != SQLITE_OK) {
+        const std::string error {error_message ? error_message : "unknown error"};
+        sqlite3_free(error_message);
+        throw std::runtime_error("Failed to execute \"" + sql + "\": " + error);
     }
-    // Else:
-    return false;
+}
+
+sqlite_orm::internal::connection_ref Database::connection(Storage &storage) {
+    /*
+     * Get the storage's SQLite connection, opening it if needed. The connection stays open while the returned
+     * reference is alive, so raw statements run on the same connection as everything else.
+     * @param storage: A storage instance.
+     */
+
+    return ConnectionAccess::get(storage);
+}
+
+void Database::create_daily_totals(Storage &storage) {
+    /*
+     * Create the daily_totals table and the triggers that keep it current, if they don't exist. If sync_schema
+     * rebuilt the drinks table, its triggers went with it, so they are recreated and the totals refilled.
+     * @param storage: A storage instance.
+     */
+
+    auto db = connection(storage);
+    const bool has_triggers {!schema_has(db.get(), "SELECT 3 - COUNT(*) FROM sqlite_master WHERE type = 'trigger' AND "
+                                                   "name IN ('daily_totals_insert', 'daily_totals_delete', "
+                                                   "'daily_totals_update')")};
+    if (!has_triggers) {
+        execute(storage, daily_totals_schema);
+        rebuild_daily_totals(storage);
+    }
+}
+
+void Database::drop_daily_totals_triggers(Storage &storage) {
+    /*
+     * Stop maintaining daily_totals row by row, for bulk writes such as imports. Call create_daily_totals afterwards
+     * to restore the triggers and refill the totals once. If that never happens, the next startup does it.
+     * @param storage: A storage instance.
+     */
+
+    execute(storage, "DROP TRIGGER IF EXISTS daily_totals_insert;"
+                     "DROP TRIGGER IF EXISTS daily_totals_delete;"
+                     "DROP TRIGGER IF EXISTS daily_totals_update;");
+}
+
+void Database::rebuild_daily_totals(Storage &storage) {
+    /*
+     * Refill the daily_totals table from the drinks table.
+     * @param storage: A storage instance.
+     */
+
+    execute(storage, "SAVEPOINT rebuild_daily_totals;"
+                     "DELETE FROM daily_totals;"
+                     "INSERT INTO daily_totals (day, alcohol_type, alcohol_volume, drinks) "
+                     "SELECT day, alcohol_type, SUM(abv / 100.0 * _size), COUNT(*) FROM drinks GROUP BY day, alcohol_type;"
+                     "RELEASE rebuild_daily_totals;");
+}
+
+std::vector<DailyTotal> Database::daily_totals(Storage &storage, const int first_day, const int last_day) {
+    /*
+     * Read the per-day, per-alcohol type totals for a range of days. This reads one row per day and type rather
+     * than one per drink.
+     * @param storage: A storage instance.
+     * @param first_day: First day number to read, inclusive.
+     * @param last_day: Last day number to read, inclusive.
+     * @return: The totals, ordered by day and then alcohol type.
+     */
+
+    auto db = connection(storage);
+    const Statement statement {prepare_statement(db.get(), "SELECT day, alcohol_type, alcohol_volume, drinks "
+                                                           "FROM daily_totals WHERE day BETWEEN ? AND ? "
+                                                           "ORDER BY day, alcohol_type")};
+    sqlite3_bind_int(statement.get(), 1, first_day);
+    sqlite3_bind_int(statement.get(), 2, last_day);
+
+    std::vector<DailyTotal> totals;
+    int rc;
+    while ((rc = sqlite3_step(statement.get())) == SQLITE_ROW) {
+        totals.push_back({sqlite3_column_int(statement.get(), 0), column_text(statement.get(), 1),
+                          sqlite3_column_double(statement.get(), 2), sqlite3_column_int(statement.get(), 3)});
+    }
+    if (rc != SQLITE_DONE) {
+        throw std::runtime_error(std::string("Failed to read daily totals: ") + sqlite3_errmsg(db.get()));
+    }
+    return totals;
 }
 
 void Database::sort_by_date_id(std::vector<Drink> &drinks) {
     /*
-     * Adds a sort column integer to database.
+     * Adds a sort column integer to database. Database::read and Database::filter already return drinks in this
+     * order, so the sort is only a cheap integer check for them.
      */
 
     // First sort by entered date
-    std::sort(drinks.begin(), drinks.end(), compare_date);
+    if (!std::is_sorted(drinks.begin(), drinks.end(), compare_date)) {
+        std::sort(drinks.begin(), drinks.end(), compare_date);
+    }
     // Now add sort order value
     int sort_order = 1;
     for (unsigned i = 0; i < drinks.size(); ++i) { // NOLINT(modernize-loop-convert)
@@ -3,6 +3,7 @@
 
 #include "../include/sqlite_orm.h"
 #include "drink.h"
+#include <functional>
 #include <vector>
 #include <QDate>
 
@@ -13,6 +14,13 @@ inline auto initStorage(const std::string &file_name) {
 
     const std::string table_name = "drinks";
     return sqlite_orm::make_storage(file_name,
+                                    // Indexes are created by sync_schema, which runs from the migration in increment_version
+                                    sqlite_orm::make_index("idx_drinks_day_id", &Drink::day, &Drink::id),
+                                    sqlite_orm::make_index("idx_drinks_alcohol_type_name_producer", &Drink::alcohol_type,
+                                                           &Drink::name, &Drink::producer),
+                                    sqlite_orm::make_index("idx_drinks_producer", &Drink::producer),
+                                    sqlite_orm::make_index("idx_drinks_type", &Drink::type),
+                                    sqlite_orm::make_index("idx_drinks_subtype", &Drink::subtype),
                                     sqlite_orm::make_table(table_name,
                                                            sqlite_orm::make_column("id", &Drink::id,
                                                                                    sqlite_orm::autoincrement(),
@@ -32,29 +40,45 @@ inline auto initStorage(const std::string &file_name) {
                                                           sqlite_orm::make_column("notes", &Drink::notes),
                                                           sqlite_orm::make_column("vintage", &Drink::vintage, sqlite_orm::default_value(-999)),
                                                           sqlite_orm::make_column("alcohol_type", &Drink::alcohol_type, sqlite_orm::default_value("Beer")),
-                                                          sqlite_orm::make_column("timestamp", &Drink::timestamp, sqlite_orm::default_value(sqlite_orm::datetime("now", "localtime")))));
+                                                          sqlite_orm::make_column("timestamp", &Drink::timestamp, sqlite_orm::default_value(sqlite_orm::datetime("now", "localtime"))),
+                                                          sqlite_orm::make_column("day", &Drink::day, sqlite_orm::default_value(0))));
 }
 
 using Storage = decltype(initStorage(""));
 
+struct DailyTotal {
+    // One row of the daily_totals table, which triggers on drinks keep current
+    int day {0};
+    std::string alcohol_type;
+    double alcohol_volume {0.0};  // oz
+    int drinks {0};
+};
+
 class Database
 {
 public:
-    static const int db_version {8};
-    static std::vector<Drink> read(Storage storage);
-    static Storage write(Drink drink, Storage storage);
-    static void truncate(Storage storage);
+    static constexpr int db_version {11};
+    static std::vector<Drink> read(Storage &storage);
+    static void for_each(Storage &storage, const std::function<void(const Drink &)> &visit);
+    static int write(Drink drink, Storage &storage);
+    static void truncate(Storage &storage);
     static void delete_row(Storage &storage, const int &row_num);
     static Drink read_row(const int &row_num, Storage &storage);
-    static void update(Storage storage, const Drink& drink);
-    static std::vector<Drink> filter(const std::string& filter_type, const std::string& filter_text, Storage storage);
+    static void update(Storage &storage, const Drink& drink);
+    static std::vector<Drink> filter(const std::string& filter_type, const std::string& filter_text, Storage &storage);
     static void write_db_to_disk(Storage &storage);
     static Drink get_drink_by_name(Storage &storage, const std::string &alcohol_type, const std::string &drink_name);
     static Drink get_drink_by_name(Storage &storage, const std::string &alcohol_type, const std::string &drink_name, const std::string &producer);
     static std::vector<Drink> get_drinks_by_type(Storage &storage, std::string drink_type);
     static std::vector<Drink> get_drinks_by_producer(Storage &storage, std::string producer);
-    static int get_version(Storage storage);
-    static int increment_version(Storage storage, int current_version);
+    static int get_version(Storage &storage);
+    static int increment_version(Storage &storage, int current_version);
+    static void execute(Storage &storage, const std::string &sql);
+    static sqlite_orm::internal::connection_ref connection(Storage &storage);
+    static void create_daily_totals(Storage &storage);
+    static void drop_daily_totals_triggers(Storage &storage);
+    static void rebuild_daily_totals(Storage &storage);
+    static std::vector<DailyTotal> daily_totals(Storage &storage, int first_day, int last_day);
     static void sort_by_date_id(std::vector<Drink> &drinks);
     static std::string get_latest_notes(Storage &storage, const std::string& name, const std::string& alcohol_type);
 
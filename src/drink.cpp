@@ -3,6 +3,7 @@
 //
 
 #include "drink.h"
+#include "settings_snapshot.h"
 
 void Drink::set_id(const int &in_id) {
     /*
@@ -22,6 +23,7 @@ void Drink::set_date(const std::string &in_date) {
      */
 
     date = in_date;
+    day = civil_date::from_iso(in_date);
 }
 
 void Drink::set_name(const std::string &in_name) {
@@ -170,6 +172,14 @@ std::string Drink::get_date() const {
     return date;
 }
 
+int Drink::get_day() const {
+    /*
+     * Get drink date as a day number, for cheap comparisons.
+     * @return: Days since 1970-01-01
+     */
+    return day;
+}
+
 std::string Drink::get_name() const {
     /*
      * Get drink name.
@@ -275,19 +285,24 @@ int Drink::get_sort_order() const {
 }
 
 double Drink::get_standard_drinks() const {
+    /*
+     * Calculate the number of standard drinks in a drink, using the standard drink size from the current settings
+     * snapshot. Loops over many drinks should fetch the size once and use the overload below.
+     */
+
+    return get_standard_drinks(SettingsSnapshot::current()->std_drink_size);
+}
+
+double Drink::get_standard_drinks(const double &std_drink_size) const {
     /*
      * Calculate the number of standard drinks in a drink.
      * 1 Std. drink in the US is .6 oz pure alcohol. In Europe,
      * it's 17.5 ml pure alcohol. These two measurements are
      * roughly the same.
-     * @param abv: the alcohol by volume of the drink.
-     * @param amount: the amount of drink in the container.
-     * @param std_drink_size: the size of the standard drink, in the same unit as amount.
+     * @param std_drink_size: the size of the standard drink, in the same unit as the drink size.
      */
 
-    Options options;  // Reads options from FS
     const double alcohol_amt = get_alcohol_volume();
-    const double std_drink_size{utilities::get_std_drink_size()};
 
     return utilities::round_to_two_decimal_points(alcohol_amt / std_drink_size);
 }
@@ -8,11 +8,13 @@
 #include <string>
 #include "utilities.h"
 #include "options.h"
+#include "civil_date.h"
 
 class Drink {
 private:
     int id;
     std::string date;
+    int day {0};  // date as days since 1970-01-01, kept in sync by set_date()
     std::string name;
     std::string type;
     std::string subtype;
@@ -20,7 +22,7 @@ private:
     double abv;
     double ibu;
     double _size;  // TODO: Remove after moving to size column
-    double size;
+    double size {0.0};  // Not yet written; sizes live in _size
     int rating;
     std::string notes;
     int vintage;
@@ -53,6 +55,7 @@ public:
     // Getters
     int get_id() const;
     std::string get_date() const;
+    int get_day() const;
     std::string get_name() const;
     std::string get_type() const;
     std::string get_subtype() const;
@@ -69,6 +72,7 @@ public:
 
     // Methods
     double get_standard_drinks() const;
+    double get_standard_drinks(const double &std_drink_size) const;
     double get_alcohol_volume() const;
 };
 
@@ -0,0 +1,257 @@
+#include "drink_columns.h"
+#include "utilities.h"
+#include <algorithm>
+
+void DrinkColumns::assign(const std::vector<Drink> &drinks) {
+    /*
+     * Replace the stored drinks. The string pool is kept, so strings seen before aren't copied again.
+     * @param drinks: Drinks in table order.
+     */
+
+    ids.clear();
+    days.clear();
+    names.clear();
+    types.clear();
+    subtypes.clear();
+    producers.clear();
+    abvs.clear();
+    ibus.clear();
+    sizes.clear();
+    ratings.clear();
+    timestamps.clear();
+
+    const std::size_t count {drinks.size()};
+    ids.reserve(count);
+    days.reserve(count);
+    names.reserve(count);
+    types.reserve(count);
+    subtypes.reserve(count);
+    producers.reserve(count);
+    abvs.reserve(count);
+    ibus.reserve(count);
+    sizes.reserve(count);
+    ratings.reserve(count);
+    timestamps.reserve(count);
+
+    for (const Drink &drink : drinks) {
+        append(drink);
+    }
+}
+
+void DrinkColumns::append(const Drink &drink) {
+    /*
+     * Add a drink after the last row.
+     */
+
+    ids.push_back(drink.get_id());
+    days.push_back(drink.get_day());
+    names.push_back(intern(drink.get_name()));
+    types.push_back(intern(drink.get_type()));
+    subtypes.push_back(intern(drink.get_subtype()));
+    producers.push_back(intern(drink.get_producer()));
+    abvs.push_back(drink.get_abv());
+    ibus.push_back(drink.get_ibu());
+    sizes.push_back(drink.get_size());
+    ratings.push_back(drink.get_rating());
+    timestamps.push_back(drink.get_timestamp());
+}
+
+void DrinkColumns::set(const std::size_t row, const Drink &drink) {
+    /*
+     * Overwrite the drink at a row.
+     * @param row: The row. Must exist.
+     * @param drink: The new values, ID included.
+     */
+
+    ids[row] = drink.get_id();
+    days[row] = drink.get_day();
+    names[row] = intern(drink.get_name());
+    types[row] = intern(drink.get_type());
+    subtypes[row] = intern(drink.get_subtype());
+    producers[row] = intern(drink.get_producer());
+    abvs[row] = drink.get_abv();
+    ibus[row] = drink.get_ibu();
+    sizes[row] = drink.get_size();
+    ratings[row] = drink.get_rating();
+    timestamps[row] = drink.get_timestamp();
+}
+
+void DrinkColumns::erase(const std::size_t row) {
+    /*
+     * Remove the drink at a row. Later rows move up by one. Its strings stay in the pool until clear().
+     * @param row: The row. Must exist.
+     */
+
+    const auto offset {static_cast<std::ptrdiff_t>(row)};
+    ids.erase(ids.begin() + offset);
+    days.erase(days.begin() + offset);
+    names.erase(names.begin() + offset);
+    types.erase(types.begin() + offset);
+    subtypes.erase(subtypes.begin() + offset);
+    producers.erase(producers.begin() + offset);
+    abvs.erase(abvs.begin() + offset);
+    ibus.erase(ibus.begin() + offset);
+    sizes.erase(sizes.begin() + offset);
+    ratings.erase(ratings.begin() + offset);
+    timestamps.erase(timestamps.begin() + offset);
+}
+
+void DrinkColumns::clear() {
+    /*
+     * Drop every drink and the string pool.
+     */
+
+    assign({});
+    strings.clear();
+    string_ids.clear();
+}
+
+std::size_t DrinkColumns::size() const {
+    /*
+     * Number of drinks stored.
+     */
+
+    return ids.size();
+}
+
+std::size_t DrinkColumns::distinct_strings() const {
+    /*
+     * Number of distinct names, types, subtypes and producers stored.
+     */
+
+    return strings.size();
+}
+
+int DrinkColumns::row_of(const int id) const {
+    /*
+     * Find the row holding a drink. A linear scan over the IDs alone, which is cheap next to the database write that
+     * comes before it.
+     * @param id: Database ID of the drink.
+     * @return: The row, or -1 if the drink isn't stored.
+     */
+
+    const auto found {std::find(ids.begin(), ids.end(), id)};
+    return found == ids.end() ? -1 : static_cast<int>(found - ids.begin());
+}
+
+int DrinkColumns::id(const std::size_t row) const {
+    /*
+     * Database ID of the drink at a row.
+     */
+
+    return ids[row];
+}
+
+int DrinkColumns::day(const std::size_t row) const {
+    /*
+     * Date of the drink at a row, as days since 1970-01-01.
+     */
+
+    return days[row];
+}
+
+const std::string &DrinkColumns::name(const std::size_t row) const {
+    /*
+     * Name of the drink at a row.
+     */
+
+    return strings[names[row]];
+}
+
+const std::string &DrinkColumns::type(const std::size_t row) const {
+    /*
+     * Type of the drink at a row.
+     */
+
+    return strings[types[row]];
+}
+
+const std::string &DrinkColumns::subtype(const std::size_t row) const {
+    /*
+     * Subtype of the drink at a row.
+     */
+
+    return strings[subtypes[row]];
+}
+
+const std::string &DrinkColumns::producer(const std::size_t row) const {
+    /*
+     * Producer of the drink at a row.
+     */
+
+    return strings[producers[row]];
+}
+
+double DrinkColumns::abv(const std::size_t row) const {
+    /*
+     * ABV of the drink at a row.
+     */
+
+    return abvs[row];
+}
+
+double DrinkColumns::ibu(const std::size_t row) const {
+    /*
+     * IBU of the drink at a row. -1 if it has none.
+     */
+
+    return ibus[row];
+}
+
+double DrinkColumns::size(const std::size_t row) const {
+    /*
+     * Size of the drink at a row, in oz.
+     */
+
+    return sizes[row];
+}
+
+double DrinkColumns::std_drinks(const std::size_t row, const double std_drink_size) const {
+    /*
+     * Standard drinks in the drink at a row, rounded like Drink::get_standard_drinks.
+     * @param row: The row.
+     * @param std_drink_size: Size of a standard drink, in oz. alcohol.
+     */
+
+    return utilities::round_to_two_decimal_points((abvs[row] / 100) * sizes[row] / std_drink_size);
+}
+
+int DrinkColumns::rating(const std::size_t row) const {
+    /*
+     * Rating of the drink at a row.
+     */
+
+    return ratings[row];
+}
+
+const std::string &DrinkColumns::timestamp(const std::size_t row) const {
+    /*
+     * Time the drink at a row was entered.
+     */
+
+    return timestamps[row];
+}
+
+long long DrinkColumns::date_order(const std::size_t row) const {
+    /*
+     * Sort key of the drink at a row that orders drinks like Database::sort_by_date_id: by date, then by ID. Unlike
+     * a stored sort order, it stays right when rows are inserted or changed one at a time.
+     */
+
+    constexpr long long ids_per_day {1LL << 32};
+    return static_cast<long long>(days[row]) * ids_per_day + static_cast<std::uint32_t>(ids[row]);
+}
+
+std::uint32_t DrinkColumns::intern(const std::string &value) {
+    /*
+     * Find a string in the pool, adding it if it's new.
+     * @param value: The string.
+     * @return: Its index in the pool.
+     */
+
+    const auto [entry, inserted] {string_ids.try_emplace(value, static_cast<std::uint32_t>(strings.size()))};
+    if (inserted) {
+        strings.push_back(value);
+    }
+    return entry->second;
+}
@@ -0,0 +1,63 @@
+#ifndef BUZZBOT_DRINK_COLUMNS_H
+#define BUZZBOT_DRINK_COLUMNS_H
+
+#include "drink.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class DrinkColumns {
+    /*
+     * The drinks behind the drink log table, stored one vector per field. Names, types, subtypes and producers repeat
+     * a lot, so each distinct string is kept once and rows hold its index. Nothing is formatted here; the table model
+     * formats a cell only when the view asks for it.
+     */
+
+public:
+    void assign(const std::vector<Drink> &drinks);
+    void append(const Drink &drink);
+    void set(std::size_t row, const Drink &drink);
+    void erase(std::size_t row);
+    void clear();
+
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] std::size_t distinct_strings() const;
+    [[nodiscard]] int row_of(int id) const;
+
+    [[nodiscard]] int id(std::size_t row) const;
+    [[nodiscard]] int day(std::size_t row) const;
+    [[nodiscard]] const std::string &name(std::size_t row) const;
+    [[nodiscard]] const std::string &type(std::size_t row) const;
+    [[nodiscard]] const std::string &subtype(std::size_t row) const;
+    [[nodiscard]] const std::string &producer(std::size_t row) const;
+    [[nodiscard]] double abv(std::size_t row) const;
+    [[nodiscard]] double ibu(std::size_t row) const;
+    [[nodiscard]] double size(std::size_t row) const;
+    [[nodiscard]] double std_drinks(std::size_t row, double std_drink_size) const;
+    [[nodiscard]] int rating(std::size_t row) const;
+    [[nodiscard]] const std::string &timestamp(std::size_t row) const;
+    [[nodiscard]] long long date_order(std::size_t row) const;
+
+private:
+    std::vector<int> ids;
+    std::vector<int> days;
+    std::vector<std::uint32_t> names;
+    std::vector<std::uint32_t> types;
+    std::vector<std::uint32_t> subtypes;
+    std::vector<std::uint32_t> producers;
+    std::vector<double> abvs;
+    std::vector<double> ibus;
+    std::vector<double> sizes;  // oz
+    std::vector<int> ratings;
+    std::vector<std::string> timestamps;
+
+    std::vector<std::string> strings;
+    std::unordered_map<std::string, std::uint32_t> string_ids;
+
+    std::uint32_t intern(const std::string &value);
+};
+
+
+#endif //BUZZBOT_DRINK_COLUMNS_H
@@ -0,0 +1,19 @@
+#include "drink_facts.h"
+#include "utilities.h"
+
+double DrinkFacts::alcohol_volume() const {
+    /*
+     * Calculate the volume of alcohol in a drink. Same as Drink::get_alcohol_volume.
+     */
+
+    return (abv/100)*size;
+}
+
+double DrinkFacts::standard_drinks(const double &std_drink_size) const {
+    /*
+     * Calculate the number of standard drinks in a drink. Same as Drink::get_standard_drinks.
+     * @param std_drink_size: the size of the standard drink, in the same unit as the drink size.
+     */
+
+    return utilities::round_to_two_decimal_points(alcohol_volume() / std_drink_size);
+}
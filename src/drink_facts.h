@@ -0,0 +1,24 @@
+#ifndef BUZZBOT_DRINK_FACTS_H
+#define BUZZBOT_DRINK_FACTS_H
+
+#include <string>
+
+struct DrinkFacts {
+    /*
+     * The few columns that stats and graphs read, without the names, notes and timestamps a full Drink carries.
+     * Read them with DrinkQuery::facts().
+     */
+
+    int day {0};  // Days since 1970-01-01
+    double abv {0.0};
+    double size {0.0};
+    double ibu {-1.0};
+    int rating {-1};
+    std::string alcohol_type;  // Short enough to stay in the small-string buffer
+
+    [[nodiscard]] double alcohol_volume() const;
+    [[nodiscard]] double standard_drinks(const double &std_drink_size) const;
+};
+
+
+#endif //BUZZBOT_DRINK_FACTS_H
@@ -0,0 +1,417 @@
+#include "drink_query.h"
+#include "sqlite_statement.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    const std::vector<DrinkColumn> all_columns {
+        DrinkColumn::Id, DrinkColumn::Date, DrinkColumn::Name, DrinkColumn::Type, DrinkColumn::Subtype,
+        DrinkColumn::Producer, DrinkColumn::Abv, DrinkColumn::Ibu, DrinkColumn::Size, DrinkColumn::Rating,
+        DrinkColumn::Notes, DrinkColumn::Vintage, DrinkColumn::AlcoholType, DrinkColumn::Timestamp
+    };
+
+    Statement prepare(sqlite3 *db, const std::string &sql, const std::vector<DrinkQuery::Value> &parameters) {
+        Statement statement {prepare_statement(db, sql)};
+
+        int index {1};
+        for (const auto &parameter : parameters) {
+            if (const auto *integer = std::get_if<int>(&parameter)) {
+                sqlite3_bind_int(statement.get(), index, *integer);
+            } else if (const auto *real = std::get_if<double>(&parameter)) {
+                sqlite3_bind_double(statement.get(), index, *real);
+            } else {
+                const auto &text = std::get<std::string>(parameter);
+                sqlite3_bind_text(statement.get(), index, text.c_str(), static_cast<int>(text.size()),
+                                  SQLITE_TRANSIENT);
+            }
+            index++;
+        }
+        return statement;
+    }
+}
+
+DrinkQuery &DrinkQuery::where(const DrinkColumn column, const Value &value) {
+    /*
+     * Require a column to equal a value. Dates are matched on the indexed day column.
+     * @param column: The column to compare.
+     * @param value: The value to match.
+     */
+
+    if (column == DrinkColumn::Date && std::holds_alternative<std::string>(value)) {
+        predicates.emplace_back("day = ?");
+        parameters.emplace_back(civil_date::from_iso(std::get<std::string>(value)));
+    } else {
+        predicates.emplace_back(std::string(column_name(column)) + " = ?");
+        parameters.push_back(value);
+    }
+    return *this;
+}
+
+DrinkQuery &DrinkQuery::alcohol_type(const std::string &alcohol_type) {
+    /*
+     * Only return drinks of one alcohol type, e.g. Beer, Wine or Liquor.
+     */
+
+    return where(DrinkColumn::AlcoholType, alcohol_type);
+}
+
+DrinkQuery &DrinkQuery::name_and_producer(const std::string &name, const std::string &producer) {
+    /*
+     * Only return drinks with this name from this producer.
+     */
+
+    where(DrinkColumn::Name, name);
+    return where(DrinkColumn::Producer, producer);
+}
+
+DrinkQuery &DrinkQuery::on_or_after(const std::string &date) {
+    /*
+     * Only return drinks on or after a date.
+     * @param date: Date in YYYY-MM-DD format.
+     */
+
+    predicates.emplace_back("day >= ?");
+    parameters.emplace_back(civil_date::from_iso(date));
+    return *this;
+}
+
+DrinkQuery &DrinkQuery::before(const std::string &date) {
+    /*
+     * Only return drinks before a date.
+     * @param date: Date in YYYY-MM-DD format.
+     */
+
+    predicates.emplace_back("day < ?");
+    parameters.emplace_back(civil_date::from_iso(date));
+    return *this;
+}
+
+DrinkQuery &DrinkQuery::between_dates(const std::string &first_date, const std::string &last_date) {
+    /*
+     * Only return drinks between two dates, inclusive.
+     * @param first_date: Date in YYYY-MM-DD format.
+     * @param last_date: Date in YYYY-MM-DD format.
+     */
+
+    predicates.emplace_back("day BETWEEN ? AND ?");
+    parameters.emplace_back(civil_date::from_iso(first_date));
+    parameters.emplace_back(civil_date::from_iso(last_date));
+    return *this;
+}
+
+DrinkQuery &DrinkQuery::rating_between(const int minimum, const int maximum) {
+    /*
+     * Only return drinks rated between two values, inclusive.
+     */
+
+    predicates.emplace_back("rating BETWEEN ? AND ?");
+    parameters.emplace_back(minimum);
+    parameters.emplace_back(maximum);
+    return *this;
+}
+
+DrinkQuery &DrinkQuery::after(const DrinkKey &key, const bool descending) {
+    /*
+     * Only return drinks that come after a drink in (date, ID) order, or before it when reading newest first. With
+     * order_by_date and limit, this reads the log a page at a time: each page starts where the last one ended, using
+     * the (day, id) index, so a page deep in the log costs the same as the first. OFFSET would scan every row it skips.
+     * @param key: The last drink of the previous page.
+     * @param descending: Whether the pages run newest first. Must match order_by_date.
+     */
+
+    predicates.emplace_back(descending ? "(day, id) < (?, ?)" : "(day, id) > (?, ?)");
+    parameters.emplace_back(key.day);
+    parameters.emplace_back(key.id);
+    return *this;
+}
+
+DrinkQuery &DrinkQuery::order_by(const DrinkColumn column, const bool descending) {
+    /*
+     * Add a sort key. Keys apply in the order they are added. Dates sort on the day column.
+     */
+
+    const std::string name {column == DrinkColumn::Date ? "day" : column_name(column)};
+    ordering.push_back(descending ? name + " DESC" : name);
+    return *this;
+}
+
+DrinkQuery &DrinkQuery::order_by_date(const bool descending) {
+    /*
+     * Sort by date, then by ID for drinks on the same date. This is the drink log's order.
+     */
+
+    order_by(DrinkColumn::Date, descending);
+    return order_by(DrinkColumn::Id, descending);
+}
+
+DrinkQuery &DrinkQuery::limit(const int in_row_limit) {
+    /*
+     * Return at most this many rows.
+     */
+
+    row_limit = in_row_limit;
+    return *this;
+}
+
+DrinkQuery &DrinkQuery::columns(const std::vector<DrinkColumn> &in_projection) {
+    /*
+     * Only read these columns. Other fields of the returned drinks are left zeroed or empty.
+     */
+
+    projection = in_projection;
+    return *this;
+}
+
+DrinkQuery &DrinkQuery::distinct() {
+    /*
+     * Return each combination of the selected columns once, e.g. every name and producer pair without reading every
+     * drink.
+     */
+
+    distinct_rows = true;
+    return *this;
+}
+
+DrinkQuery DrinkQuery::from_filter(const std::string &filter_type, const std::string &filter_text) {
+    /*
+     * Build a query from the filter category and text chosen in the main window.
+     * @param filter_type: Filter category, e.g. "Name", "After Date" or "Name & Producer".
+     * @param filter_text: Text to search for. For "Name & Producer", this is "NAME -- (PRODUCER)", or just NAME for a
+     * name made by only one producer.
+     * @return: The query, with no ordering applied.
+     */
+
+    DrinkQuery query;
+
+    if (filter_type == "Name") {
+        query.where(DrinkColumn::Name, filter_text);
+    } else if (filter_type == "Type") {
+        query.where(DrinkColumn::Type, filter_text);
+    } else if (filter_type == "Subtype") {
+        query.where(DrinkColumn::Subtype, filter_text);
+    } else if (filter_type == "Producer") {
+        query.where(DrinkColumn::Producer, filter_text);
+    } else if (filter_type == "Alcohol Type") {
+        query.alcohol_type(filter_text);
+    } else if (filter_type == "After Date") {
+        query.on_or_after(filter_text);
+    } else if (filter_type == "Rating") {
+        query.where(DrinkColumn::Rating, filter_text);
+    } else if (filter_type == "Name & Producer") {
+        // Parse the -- (PRODUCER) text to strip out drink name and producer.
+        const std::size_t separator {filter_text.find(" -- (")};
+        if (separator != std::string::npos) {
+            const std::string producer_name {filter_text.substr(separator + 5, filter_text.size() - separator - 6)};
+            query.name_and_producer(filter_text.substr(0, separator), producer_name);
+        } else {
+            query.where(DrinkColumn::Name, filter_text);  // No producer given, so match every drink with the name
+        }
+    }
+
+    return query;
+}
+
+std::string DrinkQuery::where_clause() const {
+    std::string clause;
+    for (std::size_t i = 0; i < predicates.size(); ++i) {
+        clause += (i == 0 ? " WHERE " : " AND ") + predicates[i];
+    }
+    return clause;
+}
+
+std::string DrinkQuery::sql() const {
+    /*
+     * The SELECT statement this query runs, with ? placeholders for the parameters.
+     */
+
+    std::string sql {distinct_rows ? "SELECT DISTINCT " : "SELECT "};
+    const std::vector<DrinkColumn> &selected {projection.empty() ? all_columns : projection};
+    for (std::size_t i = 0; i < selected.size(); ++i) {
+        sql += (i == 0 ? "" : ", ") + std::string(column_name(selected[i]));
+    }
+    return sql + " FROM drinks" + where_clause() + order_limit_clause();
+}
+
+std::string DrinkQuery::order_limit_clause() const {
+    std::string clause;
+    for (std::size_t i = 0; i < ordering.size(); ++i) {
+        clause += (i == 0 ? " ORDER BY " : ", ") + ordering[i];
+    }
+    if (row_limit >= 0) {
+        clause += " LIMIT " + std::to_string(row_limit);
+    }
+    return clause;
+}
+
+std::vector<Drink> DrinkQuery::run(Storage &storage) const {
+    /*
+     * Run the query on the storage's connection.
+     * @param storage: A storage instance.
+     * @return: The matching drinks.
+     */
+
+    std::vector<Drink> drinks;
+    for_each(storage, [&drinks](const Drink &drink) {
+        drinks.push_back(drink);
+    });
+    return drinks;
+}
+
+std::vector<DrinkFacts> DrinkQuery::facts(Storage &storage) const {
+    /*
+     * Run the query, reading only the columns in DrinkFacts. Column projection set with columns() is ignored.
+     * @param storage: A storage instance.
+     * @return: Facts for the matching drinks.
+     */
+
+    std::vector<DrinkFacts> facts;
+    for_each_fact(storage, [&facts](const DrinkFacts &fact) {
+        facts.push_back(fact);
+    });
+    return facts;
+}
+
+void DrinkQuery::for_each(Storage &storage, const std::function<void(const Drink &)> &visit) const {
+    /*
+     * Run the query, handing the matching drinks to a callback one at a time as SQLite steps to them. Nothing is
+     * collected, so memory use doesn't grow with the number of rows.
+     * @param storage: A storage instance. The callback must not write to it.
+     * @param visit: Called once per row. The drink is reused for the next row, so copy anything that must outlive
+     * the call.
+     */
+
+    auto connection = Database::connection(storage);
+    const Statement statement {prepare(connection.get(), sql(), parameters)};
+    const std::vector<DrinkColumn> &selected {projection.empty() ? all_columns : projection};
+
+    Drink drink {};
+    int rc;
+    while ((rc = sqlite3_step(statement.get())) == SQLITE_ROW) {
+        int index {0};
+        for (const auto column : selected) {
+            read_column(statement.get(), index, column, drink);
+        }
+        visit(drink);
+    }
+    if (rc != SQLITE_DONE) {
+        throw std::runtime_error(std::string("Failed to run drink query: ") + sqlite3_errmsg(connection.get()));
+    }
+}
+
+void DrinkQuery::for_each_fact(Storage &storage, const std::function<void(const DrinkFacts &)> &visit) const {
+    /*
+     * Like for_each, reading only the columns in DrinkFacts. Column projection set with columns() is ignored.
+     * @param storage: A storage instance. The callback must not write to it.
+     * @param visit: Called once per row with facts that are reused for the next row.
+     */
+
+    auto connection = Database::connection(storage);
+    const std::string sql {"SELECT day, abv, _size, ibu, rating, alcohol_type FROM drinks" + where_clause() +
+                           order_limit_clause()};
+    const Statement statement {prepare(connection.get(), sql, parameters)};
+
+    DrinkFacts fact;
+    int rc;
+    while ((rc = sqlite3_step(statement.get())) == SQLITE_ROW) {
+        fact.day = sqlite3_column_int(statement.get(), 0);
+        fact.abv = sqlite3_column_double(statement.get(), 1);
+        fact.size = sqlite3_column_double(statement.get(), 2);
+        fact.ibu = sqlite3_column_double(statement.get(), 3);
+        fact.rating = sqlite3_column_int(statement.get(), 4);
+        fact.alcohol_type = column_text(statement.get(), 5);
+        visit(fact);
+    }
+    if (rc != SQLITE_DONE) {
+        throw std::runtime_error(std::string("Failed to run drink query: ") + sqlite3_errmsg(connection.get()));
+    }
+}
+
+int DrinkQuery::count(Storage &storage) const {
+    /*
+     * Count the matching drinks without reading them.
+     * @param storage: A storage instance.
+     * @return: The number of matching drinks, ignoring limit.
+     */
+
+    auto connection = Database::connection(storage);
+    const Statement statement {prepare(connection.get(), "SELECT COUNT(*) FROM drinks" + where_clause(), parameters)};
+    if (sqlite3_step(statement.get()) != SQLITE_ROW) {
+        throw std::runtime_error(std::string("Failed to count drinks: ") + sqlite3_errmsg(connection.get()));
+    }
+    return sqlite3_column_int(statement.get(), 0);
+}
+
+std::vector<ValueCount> DrinkQuery::top_values(Storage &storage, const DrinkColumn column, const int k) const {
+    /*
+     * Count how often each value of a column appears in the matching drinks, grouped in SQL.
+     * @param storage: A storage instance.
+     * @param column: The column to count, e.g. DrinkColumn::Producer.
+     * @param k: The number of values to return.
+     * @return: The k most common values, most common first. Ties are ordered by value, ascending.
+     */
+
+    const std::string name {column_name(column)};
+    std::vector<Value> top_parameters {parameters};
+    top_parameters.emplace_back(k);
+
+    auto connection = Database::connection(storage);
+    const Statement statement {prepare(connection.get(), "SELECT " + name + ", COUNT(*) AS value_count FROM drinks" +
+                                                         where_clause() + " GROUP BY " + name +
+                                                         " ORDER BY value_count DESC, " + name + " ASC LIMIT ?",
+                                       top_parameters)};
+
+    std::vector<ValueCount> values;
+    values.reserve(static_cast<std::size_t>(std::max(k, 0)));
+    int rc;
+    while ((rc = sqlite3_step(statement.get())) == SQLITE_ROW) {
+        values.push_back({column_text(statement.get(), 0), sqlite3_column_int(statement.get(), 1)});
+    }
+    if (rc != SQLITE_DONE) {
+        throw std::runtime_error(std::string("Failed to count drink values: ") + sqlite3_errmsg(connection.get()));
+    }
+    return values;
+}
+
+const char *DrinkQuery::column_name(const DrinkColumn column) {
+    switch (column) {
+        case DrinkColumn::Id: return "id";
+        case DrinkColumn::Date: return "date";
+        case DrinkColumn::Name: return "drink_name";
+        case DrinkColumn::Type: return "drink_type";
+        case DrinkColumn::Subtype: return "drink_subtype";
+        case DrinkColumn::Producer: return "producer";
+        case DrinkColumn::Abv: return "abv";
+        case DrinkColumn::Ibu: return "ibu";
+        case DrinkColumn::Size: return "_size";  // Sizes are still stored in _size
+        case DrinkColumn::Rating: return "rating";
+        case DrinkColumn::Notes: return "notes";
+        case DrinkColumn::Vintage: return "vintage";
+        case DrinkColumn::AlcoholType: return "alcohol_type";
+        case DrinkColumn::Timestamp: return "timestamp";
+    }
+    return "id";
+}
+
+void DrinkQuery::read_column(sqlite3_stmt *statement, int &index, const DrinkColumn column, Drink &drink) {
+    /*
+     * Copy one result column into the matching Drink field and advance to the next column.
+     */
+
+    switch (column) {
+        case DrinkColumn::Id: drink.set_id(sqlite3_column_int(statement, index)); break;
+        case DrinkColumn::Date: drink.set_date(column_text(statement, index)); break;
+        case DrinkColumn::Name: drink.set_name(column_text(statement, index)); break;
+        case DrinkColumn::Type: drink.set_type(column_text(statement, index)); break;
+        case DrinkColumn::Subtype: drink.set_subtype(column_text(statement, index)); break;
+        case DrinkColumn::Producer: drink.set_producer(column_text(statement, index)); break;
+        case DrinkColumn::Abv: drink.set_abv(sqlite3_column_double(statement, index)); break;
+        case DrinkColumn::Ibu: drink.set_ibu(sqlite3_column_double(statement, index)); break;
+        case DrinkColumn::Size: drink.set_size(sqlite3_column_double(statement, index)); break;
+        case DrinkColumn::Rating: drink.set_rating(sqlite3_column_int(statement, index)); break;
+        case DrinkColumn::Notes: drink.set_notes(column_text(statement, index)); break;
+        case DrinkColumn::Vintage: drink.set_vintage(sqlite3_column_int(statement, index)); break;
+        case DrinkColumn::AlcoholType: drink.set_alcohol_type(column_text(statement, index)); break;
+        case DrinkColumn::Timestamp: drink.set_timestamp(column_text(statement, index)); break;
+    }
+    index++;
+}
@@ -0,0 +1,82 @@
+#ifndef BUZZBOT_DRINK_QUERY_H
+#define BUZZBOT_DRINK_QUERY_H
+
+#include "database.h"
+#include "drink_facts.h"
+#include <functional>
+#include <string>
+#include <variant>
+#include <vector>
+
+enum class DrinkColumn {
+    Id, Date, Name, Type, Subtype, Producer, Abv, Ibu, Size, Rating, Notes, Vintage, AlcoholType, Timestamp
+};
+
+struct DrinkKey {
+    /*
+     * Position of a drink in the drink log's (date, ID) order.
+     */
+
+    int day {0};
+    int id {0};
+
+    static DrinkKey of(const Drink &drink) {
+        return {drink.get_day(), drink.get_id()};
+    }
+};
+
+struct ValueCount {
+    std::string value;
+    int count {0};
+};
+
+class DrinkQuery {
+    /*
+     * Builds a SELECT on the drinks table from typed predicates, and runs it as one prepared statement with bound
+     * parameters. Predicates are combined with AND. Example:
+     *     DrinkQuery().alcohol_type("Beer").on_or_after("2022-01-01").columns({DrinkColumn::Abv}).run(storage);
+     */
+
+public:
+    using Value = std::variant<int, double, std::string>;
+
+    DrinkQuery &where(DrinkColumn column, const Value &value);
+    DrinkQuery &alcohol_type(const std::string &alcohol_type);
+    DrinkQuery &name_and_producer(const std::string &name, const std::string &producer);
+    DrinkQuery &on_or_after(const std::string &date);
+    DrinkQuery &before(const std::string &date);
+    DrinkQuery &between_dates(const std::string &first_date, const std::string &last_date);
+    DrinkQuery &rating_between(int minimum, int maximum);
+    DrinkQuery &after(const DrinkKey &key, bool descending = false);
+    DrinkQuery &order_by(DrinkColumn column, bool descending = false);
+    DrinkQuery &order_by_date(bool descending = false);
+    DrinkQuery &limit(int row_limit);
+    DrinkQuery &columns(const std::vector<DrinkColumn> &projection);
+    DrinkQuery &distinct();
+
+    static DrinkQuery from_filter(const std::string &filter_type, const std::string &filter_text);
+
+    [[nodiscard]] std::string sql() const;
+    [[nodiscard]] std::vector<Drink> run(Storage &storage) const;
+    [[nodiscard]] std::vector<DrinkFacts> facts(Storage &storage) const;
+    void for_each(Storage &storage, const std::function<void(const Drink &)> &visit) const;
+    void for_each_fact(Storage &storage, const std::function<void(const DrinkFacts &)> &visit) const;
+    [[nodiscard]] int count(Storage &storage) const;
+    [[nodiscard]] std::vector<ValueCount> top_values(Storage &storage, DrinkColumn column, int k) const;
+
+private:
+    std::vector<std::string> predicates;
+    std::vector<Value> parameters;
+    std::vector<std::string> ordering;
+    std::vector<DrinkColumn> projection;
+    int row_limit {-1};
+    bool distinct_rows {false};
+
+    [[nodiscard]] std::string where_clause() const;
+    [[nodiscard]] std::string order_limit_clause() const;
+    static const char *column_name(DrinkColumn column);
+    static void read_column(sqlite3_stmt *statement, int &index, DrinkColumn column, Drink &drink);
+};
+
+
+#endif //BUZZBOT_DRINK_QUERY_H
@@ -0,0 +1,141 @@
+#include "drink_repository.h"
+#include <cstring>
+#include <memory>
+
+namespace {
+    int count_read(const unsigned event, void *context, void *statement, void *sql) {
+        // Statements inside triggers are reported as "-- " comments; they run as part of the statement that fired them
+        if (event == SQLITE_TRACE_STMT && sqlite3_stmt_readonly(static_cast<sqlite3_stmt *>(statement)) &&
+            std::strncmp(static_cast<const char *>(sql), "--", 2) != 0) {
+            ++*static_cast<unsigned long long *>(context);
+        }
+        return 0;
+    }
+}
+
+DrinkRepository::DrinkRepository(const std::string &db_path) : db(initStorage(db_path)), drink_writer(db) {
+    /*
+     * Open the database and keep the connection open for the lifetime of the repository.
+     * @param db_path: Path to the SQLite database file.
+     */
+
+    db.open_forever();
+    sqlite3_trace_v2(Database::connection(db).get(), SQLITE_TRACE_STMT, count_read, &read_count);
+}
+
+Storage &DrinkRepository::storage() {
+    /*
+     * Get the storage backed by the repository's connection.
+     * @return: A reference to the storage. Do not copy it.
+     */
+
+    return db;
+}
+
+DrinkWriter &DrinkRepository::writer() {
+    /*
+     * Get the writer that inserts and updates drinks on the repository's connection.
+     * @return: A reference to the writer.
+     */
+
+    return drink_writer;
+}
+
+AggregateStore &DrinkRepository::aggregates() {
+    /*
+     * Get the running totals behind the stats panel.
+     * @return: A reference to the aggregates.
+     */
+
+    return aggregate_store;
+}
+
+FilterDictionary &DrinkRepository::filters() {
+    /*
+     * Get the distinct values offered by the table filter.
+     * @return: A reference to the filter values.
+     */
+
+    return filter_dictionary;
+}
+
+const std::string &DrinkRepository::path() const {
+    /*
+     * Get the path of the database file.
+     * @return: The database path.
+     */
+
+    return db.filename();
+}
+
+unsigned long long DrinkRepository::reads() const {
+    /*
+     * Number of read statements run on the repository's connection since it was opened. Writes aren't counted.
+     */
+
+    return read_count;
+}
+
+int DrinkRepository::insert(const Drink &drink) {
+    /*
+     * Insert a drink and add it to the aggregates and filter values.
+     * @param drink: The drink to insert.
+     * @return: The primary key of the inserted row.
+     */
+
+    const int inserted_id {drink_writer.insert(drink)};
+    aggregate_store.add(drink);
+    filter_dictionary.add(drink);
+    return inserted_id;
+}
+
+bool DrinkRepository::update(const Drink &drink) {
+    /*
+     * Update a drink and replace its old values in the aggregates and filter values.
+     * @param drink: The new values. The ID should match an existing row.
+     * @return: False if there is no such row, e.g. because it was deleted on another connection. Nothing is written.
+     */
+
+    const std::unique_ptr<Drink> stored_drink {db.get_pointer<Drink>(drink.get_id())};
+    if (!stored_drink) {
+        return false;
+    }
+    drink_writer.update(drink);
+    aggregate_store.replace(*stored_drink, drink);
+    filter_dictionary.replace(*stored_drink, drink);
+    return true;
+}
+
+bool DrinkRepository::remove(const int id) {
+    /*
+     * Delete a drink and remove it from the aggregates and filter values.
+     * @param id: The primary key of the drink to delete.
+     * @return: False if there is no such row, e.g. because it was deleted on another connection.
+     */
+
+    const std::unique_ptr<Drink> stored_drink {db.get_pointer<Drink>(id)};
+    if (!stored_drink) {
+        return false;
+    }
+    Database::delete_row(db, id);
+    aggregate_store.remove(*stored_drink);
+    filter_dictionary.remove(*stored_drink);
+    return true;
+}
+
+StatsSnapshot DrinkRepository::stats(const std::string &alcohol_type, const std::string &week_start,
+                                     const std::string &today, const double &std_drink_size) {
+    /*
+     * Get the stats panel values from the aggregates, rebuilding them first if they are stale or were built for
+     * another standard drink size.
+     * @param alcohol_type: The alcohol type for favorites and means, i.e. the current tab.
+     * @param week_start: First date of the week, YYYY-MM-DD.
+     * @param today: Today's date, YYYY-MM-DD.
+     * @param std_drink_size: Size of a standard drink, in oz.
+     */
+
+    if (!aggregate_store.valid_for(std_drink_size)) {
+        aggregate_store.rebuild(db, std_drink_size);
+    }
+    return aggregate_store.snapshot(alcohol_type, week_start, today);
+}
@@ -0,0 +1,48 @@
+#ifndef BUZZBOT_DRINK_REPOSITORY_H
+#define BUZZBOT_DRINK_REPOSITORY_H
+
+#include "aggregate_store.h"
+#include "database.h"
+#include "drink_writer.h"
+#include "filter_dictionary.h"
+#include <string>
+
+class DrinkRepository {
+    /*
+     * Owns the single long-lived connection to the drinks database. The connection is opened once, when the
+     * repository is created, and stays open until it is destroyed. Pass the repository, or the Storage it hands out,
+     * by reference; copying a Storage opens a second connection.
+     * Writes made through insert(), update() and remove() are also applied to the stats aggregates and the filter
+     * values. Writes made any other way, e.g. by an import, must be followed by aggregates().invalidate() and
+     * filters().invalidate().
+     * Every read statement run on the connection is counted, so callers can log how many reads an action cost.
+     */
+
+public:
+    explicit DrinkRepository(const std::string &db_path);
+    DrinkRepository(const DrinkRepository &) = delete;
+    DrinkRepository &operator=(const DrinkRepository &) = delete;
+
+    Storage &storage();
+    DrinkWriter &writer();
+    AggregateStore &aggregates();
+    FilterDictionary &filters();
+    [[nodiscard]] const std::string &path() const;
+    [[nodiscard]] unsigned long long reads() const;
+
+    int insert(const Drink &drink);
+    bool update(const Drink &drink);
+    bool remove(int id);
+    StatsSnapshot stats(const std::string &alcohol_type, const std::string &week_start, const std::string &today,
+                        const double &std_drink_size);
+
+private:
+    Storage db;
+    DrinkWriter drink_writer;
+    AggregateStore aggregate_store;
+    FilterDictionary filter_dictionary;
+    unsigned long long read_count {0};
+};
+
+
+#endif //BUZZBOT_DRINK_REPOSITORY_H
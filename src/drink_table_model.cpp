@@ -0,0 +1,349 @@
+#include "drink_table_model.h"
+#include "calculate.h"
+#include "civil_date.h"
+#include <QDate>
+#include <array>
+#include <cmath>
+#include <iterator>
+
+namespace {
+    const std::array<const char *, DrinkTableModel::ColumnCount> column_names {
+            "Date", "Name", "Type", "Subtype", "Producer", "ABV", "IBU", "Size", "S. Drinks", "Rating", "ID",
+            "Timestamp", "Sort"};
+
+    QString to_qstring(const double value) {
+        return QString::fromStdString(Calculate::double_to_string(value));
+    }
+}
+
+DrinkTableModel::DrinkTableModel(QObject *parent) : QAbstractTableModel(parent) {}
+
+void DrinkTableModel::set_query(Storage &in_storage, const DrinkQuery &in_filter, const double in_std_drink_size,
+                                const bool in_metric) {
+    /*
+     * Replace every row of the table with the first page of drinks that pass a filter, or with all of them if the
+     * view sorts other than newest first.
+     * @param in_storage: The storage to read pages from. Must outlive the model.
+     * @param in_filter: The drinks to show, with no ordering or limit applied.
+     * @param in_std_drink_size: Size of a standard drink, in oz. alcohol.
+     * @param in_metric: Show sizes in ml instead of oz.
+     */
+
+    beginResetModel();
+    storage = &in_storage;
+    filter = in_filter;
+    std_drink_size = in_std_drink_size;
+    metric = in_metric;
+    last_key.reset();
+    fetched_all = false;
+    columns.assign(read_pages());
+    endResetModel();
+}
+
+void DrinkTableModel::insert_drink(const Drink &drink) {
+    /*
+     * Add one drink as a new row. The proxy puts it in its sorted place, so only that row is laid out. A drink older
+     * than every drink loaded so far is left for the page that will read it.
+     * @param drink: The drink as written, with the ID the database gave it.
+     */
+
+    if (!is_loaded(drink)) {
+        return;
+    }
+    const int row {rowCount()};
+    beginInsertRows(QModelIndex(), row, row);
+    columns.append(drink);
+    endInsertRows();
+}
+
+void DrinkTableModel::update_drink(const Drink &drink) {
+    /*
+     * Replace the values of the row holding a drink, or add a row if the table doesn't have it yet.
+     * @param drink: The drink as written.
+     */
+
+    const int row {columns.row_of(drink.get_id())};
+    if (row < 0) {
+        insert_drink(drink);
+        return;
+    }
+    if (!is_loaded(drink)) {  // Moved back past the loaded pages. It'll be read again with its new page.
+        remove_drink(drink.get_id());
+        return;
+    }
+    columns.set(static_cast<std::size_t>(row), drink);
+    emit dataChanged(index(row, 0), index(row, ColumnCount - 1));
+}
+
+void DrinkTableModel::remove_drink(const int id) {
+    /*
+     * Remove the row holding a drink, if the table has it.
+     * @param id: Database ID of the drink.
+     */
+
+    const int row {columns.row_of(id)};
+    if (row < 0) {
+        return;
+    }
+    beginRemoveRows(QModelIndex(), row, row);
+    columns.erase(static_cast<std::size_t>(row));
+    endRemoveRows();
+}
+
+void DrinkTableModel::set_units(const double in_std_drink_size, const bool in_metric) {
+    /*
+     * Change how sizes and standard drinks are shown. Only those two columns are redrawn; the drinks aren't reloaded.
+     * @param in_std_drink_size: Size of a standard drink, in oz. alcohol.
+     * @param in_metric: Show sizes in ml instead of oz.
+     */
+
+    if (in_std_drink_size == std_drink_size && in_metric == metric) {
+        return;
+    }
+    std_drink_size = in_std_drink_size;
+    metric = in_metric;
+    if (rowCount() > 0) {
+        emit dataChanged(index(0, Size), index(rowCount() - 1, StdDrinks));
+    }
+}
+
+void DrinkTableModel::sort_changed(const int column, const Qt::SortOrder order) {
+    /*
+     * Follow the view's sort. Connected to the header's sortIndicatorChanged. Sorting by anything but newest first
+     * reads the pages not loaded yet, since the drinks that sort to the top may be on any of them.
+     * @param column: The column sorted by.
+     * @param order: The sort order.
+     */
+
+    read_all = !((column == Date || column == SortOrder) && order == Qt::DescendingOrder);
+    if (read_all) {
+        fetchMore(QModelIndex());
+    }
+}
+
+int DrinkTableModel::id_at(const int row) const {
+    /*
+     * Database ID of the drink at a model row.
+     * @return: The ID, or -1 if there is no such row.
+     */
+
+    if (row < 0 || static_cast<std::size_t>(row) >= columns.size()) {
+        return -1;
+    }
+    return columns.id(static_cast<std::size_t>(row));
+}
+
+std::string DrinkTableModel::timestamp_at(const int row) const {
+    /*
+     * Entry timestamp of the drink at a model row.
+     * @return: The timestamp, or an empty string if there is no such row.
+     */
+
+    if (row < 0 || static_cast<std::size_t>(row) >= columns.size()) {
+        return "";
+    }
+    return columns.timestamp(static_cast<std::size_t>(row));
+}
+
+int DrinkTableModel::rowCount(const QModelIndex &parent) const {
+    /*
+     * Number of drinks. A table has no children, so any valid parent has no rows.
+     */
+
+    return parent.isValid() ? 0 : static_cast<int>(columns.size());
+}
+
+int DrinkTableModel::columnCount(const QModelIndex &parent) const {
+    /*
+     * Number of columns, including the hidden ID, timestamp and sort columns.
+     */
+
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant DrinkTableModel::data(const QModelIndex &index, const int role) const {
+    /*
+     * Format one cell.
+     * @param index: The cell.
+     * @param role: Qt::DisplayRole for the text shown, or sort_role for the raw value to sort by.
+     * @return: The value, or an empty QVariant for other roles.
+     */
+
+    if (!index.isValid() || index.row() >= rowCount() || index.column() >= ColumnCount) {
+        return {};
+    }
+
+    const auto row {static_cast<std::size_t>(index.row())};
+    if (role == Qt::DisplayRole) {
+        return display_value(row, index.column());
+    }
+    if (role == sort_role) {
+        return sort_value(row, index.column());
+    }
+    return {};
+}
+
+QVariant DrinkTableModel::headerData(const int section, const Qt::Orientation orientation, const int role) const {
+    /*
+     * Column names across the top. Rows are numbered by the base class.
+     */
+
+    if (role == Qt::DisplayRole && orientation == Qt::Horizontal && section >= 0 && section < ColumnCount) {
+        return QString(column_names[static_cast<std::size_t>(section)]);
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+bool DrinkTableModel::canFetchMore(const QModelIndex &parent) const {
+    /*
+     * Whether there are drinks past the last page read.
+     */
+
+    return !parent.isValid() && !fetched_all;
+}
+
+void DrinkTableModel::fetchMore(const QModelIndex &parent) {
+    /*
+     * Read the next page of drinks, or every page left if the view sorts other than newest first, and add them below
+     * the loaded rows. Called by the view as it scrolls to the end.
+     */
+
+    if (parent.isValid() || fetched_all) {
+        return;
+    }
+
+    const std::vector<Drink> page {read_pages()};
+    if (page.empty()) {
+        return;
+    }
+    const int first_row {rowCount()};
+    beginInsertRows(QModelIndex(), first_row, first_row + static_cast<int>(page.size()) - 1);
+    for (const Drink &drink : page) {
+        columns.append(drink);
+    }
+    endInsertRows();
+}
+
+std::vector<Drink> DrinkTableModel::read_pages() {
+    /*
+     * Read the next page, or every page left to the end of the log if read_all is set.
+     */
+
+    std::vector<Drink> drinks {read_page()};
+    while (read_all && !fetched_all) {
+        std::vector<Drink> page {read_page()};
+        drinks.insert(drinks.end(), std::make_move_iterator(page.begin()), std::make_move_iterator(page.end()));
+    }
+    return drinks;
+}
+
+std::vector<Drink> DrinkTableModel::read_page() {
+    /*
+     * Read up to page_size drinks, newest first, starting after the last one read.
+     * @return: The drinks. Fewer than page_size means the end of the log was reached.
+     */
+
+    if (storage == nullptr) {
+        fetched_all = true;
+        return {};
+    }
+
+    DrinkQuery page_query {filter};
+    if (last_key) {
+        page_query.after(*last_key, true);
+    }
+    std::vector<Drink> page {page_query.order_by_date(true).limit(page_size).run(*storage)};
+
+    if (page.size() < static_cast<std::size_t>(page_size)) {
+        fetched_all = true;
+    }
+    if (!page.empty()) {
+        last_key = DrinkKey::of(page.back());
+    }
+    return page;
+}
+
+bool DrinkTableModel::is_loaded(const Drink &drink) const {
+    /*
+     * Whether a drink falls in the pages read so far: everything once the log is read to the end, otherwise drinks no
+     * older than the last one read.
+     */
+
+    if (fetched_all || !last_key) {
+        return true;
+    }
+    return drink.get_day() > last_key->day || (drink.get_day() == last_key->day && drink.get_id() >= last_key->id);
+}
+
+double DrinkTableModel::display_size(const std::size_t row) const {
+    /*
+     * Size of the drink at a row in the units picked in settings. ml are rounded to the tenth.
+     */
+
+    if (!metric) {
+        return columns.size(row);
+    }
+    return std::floor(Calculate::oz_to_ml(columns.size(row)) * 10 + 0.5) / 10;
+}
+
+QVariant DrinkTableModel::display_value(const std::size_t row, const int column) const {
+    /*
+     * Text, or date, shown in a cell.
+     */
+
+    switch (column) {
+        case Date: {
+            const YearMonthDay date {civil_date::civil_from_days(columns.day(row))};
+            return QDate(date.year, static_cast<int>(date.month), static_cast<int>(date.day));
+        }
+        case Name:
+            return QString::fromStdString(columns.name(row));
+        case Type:
+            return QString::fromStdString(columns.type(row));
+        case Subtype:
+            return QString::fromStdString(columns.subtype(row));
+        case Producer:
+            return QString::fromStdString(columns.producer(row));
+        case Abv:
+            return to_qstring(columns.abv(row));
+        case Ibu:
+            return columns.ibu(row) == -1.0 ? QString() : to_qstring(columns.ibu(row));  // Blank IBU
+        case Size:
+            return to_qstring(display_size(row));
+        case StdDrinks:
+            return to_qstring(columns.std_drinks(row, std_drink_size));
+        case Rating:
+            return QString::number(columns.rating(row));
+        case Id:
+            return columns.id(row);
+        case Timestamp:
+            return QString::fromStdString(columns.timestamp(row));
+        case SortOrder:
+            return columns.date_order(row);
+        default:
+            return {};
+    }
+}
+
+QVariant DrinkTableModel::sort_value(const std::size_t row, const int column) const {
+    /*
+     * Raw value of a cell, for sorting. Text columns sort by their text.
+     */
+
+    switch (column) {
+        case Date:
+            return columns.day(row);
+        case Abv:
+            return columns.abv(row);
+        case Ibu:
+            return columns.ibu(row);
+        case Size:
+            return columns.size(row);
+        case StdDrinks:
+            return columns.std_drinks(row, std_drink_size);
+        case Rating:
+            return columns.rating(row);
+        default:
+            return display_value(row, column);
+    }
+}
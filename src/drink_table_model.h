@@ -0,0 +1,71 @@
+#ifndef BUZZBOT_DRINK_TABLE_MODEL_H
+#define BUZZBOT_DRINK_TABLE_MODEL_H
+
+#include "drink_columns.h"
+#include "drink_query.h"
+#include <QAbstractTableModel>
+#include <optional>
+#include <vector>
+
+class DrinkTableModel : public QAbstractTableModel {
+    /*
+     * Model behind the drink log table. Rows live in a DrinkColumns store and each cell is formatted when the view
+     * asks for it, so only the rows on screen are ever turned into text. Sorting goes through a proxy using
+     * sort_role, which gives the raw value of a cell: numbers sort as numbers and dates as days.
+     * Drinks are read a page at a time, newest first, as the view scrolls down to them (canFetchMore/fetchMore).
+     * That only holds while the view sorts newest first. Sorted any other way, the first page isn't the top of the
+     * sorted log, so sort_changed reads every page and the proxy sorts the whole log.
+     * After a write, only the drink written is patched in, with insert_drink, update_drink or remove_drink. set_query
+     * starts over from the first page and is only needed when the set of drinks shown changes, e.g. a new filter or an
+     * import.
+     */
+
+Q_OBJECT
+
+public:
+    enum Column {
+        Date, Name, Type, Subtype, Producer, Abv, Ibu, Size, StdDrinks, Rating, Id, Timestamp, SortOrder, ColumnCount
+    };
+    static constexpr int sort_role {Qt::UserRole};
+    static constexpr int page_size {256};
+
+    explicit DrinkTableModel(QObject *parent = nullptr);
+
+    void set_query(Storage &in_storage, const DrinkQuery &in_filter, double in_std_drink_size, bool in_metric);
+    void insert_drink(const Drink &drink);
+    void update_drink(const Drink &drink);
+    void remove_drink(int id);
+    void set_units(double in_std_drink_size, bool in_metric);
+    void sort_changed(int column, Qt::SortOrder order);
+    [[nodiscard]] int id_at(int row) const;
+    [[nodiscard]] std::string timestamp_at(int row) const;
+
+    [[nodiscard]] int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    [[nodiscard]] int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    [[nodiscard]] QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    [[nodiscard]] QVariant headerData(int section, Qt::Orientation orientation,
+                                      int role = Qt::DisplayRole) const override;
+    [[nodiscard]] bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+private:
+    DrinkColumns columns;
+    double std_drink_size {0.6};
+    bool metric {false};
+    Storage *storage {nullptr};
+    DrinkQuery filter;
+    std::optional<DrinkKey> last_key;  // Last drink read, i.e. the oldest one loaded
+    bool fetched_all {true};
+    bool read_all {false};  // Sorted other than newest first, so every page is needed
+
+    std::vector<Drink> read_pages();
+    std::vector<Drink> read_page();
+    [[nodiscard]] bool is_loaded(const Drink &drink) const;
+
+    [[nodiscard]] double display_size(std::size_t row) const;
+    [[nodiscard]] QVariant display_value(std::size_t row, int column) const;
+    [[nodiscard]] QVariant sort_value(std::size_t row, int column) const;
+};
+
+
+#endif //BUZZBOT_DRINK_TABLE_MODEL_H
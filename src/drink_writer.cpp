@@ -0,0 +1,157 @@
+#include "drink_writer.h"
+#include <iostream>
+
+DrinkWriter::DrinkWriter(Storage &in_storage, const std::size_t in_batch_size, const Durability durability) :
+    storage(in_storage), batch_size(in_batch_size == 0 ? 1 : in_batch_size) {
+    /*
+     * Create a writer on an open storage.
+     * @param in_storage: The storage to write to. Must outlive the writer.
+     * @param in_batch_size: Number of writes committed together. 1 commits every write immediately.
+     * @param durability: How hard SQLite should try to get each commit onto disk.
+     */
+
+    set_durability(durability);
+}
+
+DrinkWriter::~DrinkWriter() {
+    /*
+     * Commit anything still pending.
+     */
+
+    try {
+        flush();
+    } catch (const std::system_error &e) {
+        std::cerr << "Could not commit pending drinks: " << e.what() << std::endl;
+    }
+}
+
+int DrinkWriter::insert(const Drink &drink) {
+    /*
+     * Insert a drink through the prepared INSERT statement.
+     * @param drink: The drink to insert. Its id is ignored.
+     * @return: The primary key of the new row.
+     */
+
+    begin_batch();
+    int inserted_id;
+    try {
+        if (!insert_statement) {
+            insert_statement.reset(new InsertStatement(storage.prepare(sqlite_orm::insert(drink))));
+        } else {
+            sqlite_orm::get<0>(*insert_statement) = drink;
+        }
+        inserted_id = static_cast<int>(storage.execute(*insert_statement));
+    } catch (...) {
+        rollback_batch();
+        throw;
+    }
+    end_write();
+
+    return inserted_id;
+}
+
+void DrinkWriter::update(const Drink &drink) {
+    /*
+     * Update a drink through the prepared UPDATE statement.
+     * @param drink: The drink to update. Its id must match an existing primary key.
+     */
+
+    begin_batch();
+    try {
+        if (!update_statement) {
+            update_statement.reset(new UpdateStatement(storage.prepare(sqlite_orm::update(drink))));
+        } else {
+            sqlite_orm::get<0>(*update_statement) = drink;
+        }
+        storage.execute(*update_statement);
+    } catch (...) {
+        rollback_batch();
+        throw;
+    }
+    end_write();
+}
+
+void DrinkWriter::flush() {
+    /*
+     * Commit the open batch, if there is one. If the commit fails, the batch is rolled back before the error is
+     * rethrown, so it is never committed later by accident.
+     */
+
+    if (in_transaction) {
+        try {
+            storage.commit();
+        } catch (...) {
+            rollback_batch();
+            throw;
+        }
+        in_transaction = false;
+        pending_writes = 0;
+    }
+}
+
+void DrinkWriter::set_batch_size(const std::size_t new_batch_size) {
+    /*
+     * Change how many writes are committed together. Pending writes are committed first.
+     * @param new_batch_size: Number of writes per transaction. 0 is treated as 1.
+     */
+
+    flush();
+    batch_size = (new_batch_size == 0) ? 1 : new_batch_size;
+}
+
+void DrinkWriter::set_durability(const Durability new_durability) {
+    /*
+     * Set PRAGMA synchronous for the connection. It cannot change inside a transaction, so pending writes are
+     * committed first.
+     * @param new_durability: The durability level to use for following commits.
+     */
+
+    flush();
+    storage.pragma.synchronous(static_cast<int>(new_durability));
+}
+
+std::size_t DrinkWriter::pending() const {
+    /*
+     * Get the number of uncommitted writes.
+     * @return: Writes made since the last commit.
+     */
+
+    return pending_writes;
+}
+
+void DrinkWriter::begin_batch() {
+    /*
+     * Open a transaction if no batch is in progress.
+     */
+
+    if (!in_transaction) {
+        storage.begin_transaction();
+        in_transaction = true;
+    }
+}
+
+void DrinkWriter::end_write() {
+    /*
+     * Count a finished write and commit once the batch is full.
+     */
+
+    pending_writes++;
+    if (pending_writes >= batch_size) {
+        flush();
+    }
+}
+
+void DrinkWriter::rollback_batch() {
+    /*
+     * Roll back the open batch after a failed write, so a batch is committed completely or not at all.
+     */
+
+    if (in_transaction) {
+        in_transaction = false;
+        pending_writes = 0;
+        // SQLite may have rolled back already, e.g. after a failed commit
+        if (!sqlite3_get_autocommit(Database::connection(storage).get())) {
+            storage.rollback();
+        }
+    }
+}
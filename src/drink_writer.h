@@ -0,0 +1,52 @@
+#ifndef BUZZBOT_DRINK_WRITER_H
+#define BUZZBOT_DRINK_WRITER_H
+
+#include "database.h"
+#include <cstddef>
+#include <memory>
+
+enum class Durability {
+    Full = 2,    // fsync at every commit
+    Normal = 1,  // fsync at checkpoints; a power loss may roll back the last commit
+    Off = 0      // leave flushing to the OS; only for rebuildable data such as imports
+};
+
+class DrinkWriter {
+    /*
+     * Transaction-batched insert/update path. Statements are prepared once and re-bound for every row. Writes are
+     * collected in an open transaction that is committed once batch_size writes are pending, on flush(), or when the
+     * writer is destroyed. The schema is never synced here; that happens once, in the startup migration.
+     */
+
+public:
+    explicit DrinkWriter(Storage &in_storage, std::size_t in_batch_size = 1, Durability durability = Durability::Normal);
+    DrinkWriter(const DrinkWriter &) = delete;
+    DrinkWriter &operator=(const DrinkWriter &) = delete;
+    ~DrinkWriter();
+
+    int insert(const Drink &drink);
+    void update(const Drink &drink);
+    void flush();
+    void set_batch_size(std::size_t new_batch_size);
+    void set_durability(Durability new_durability);
+    [[nodiscard]] std::size_t pending() const;
+
+private:
+    using InsertStatement = decltype(std::declval<Storage &>().prepare(sqlite_orm::insert(Drink{})));
+    using UpdateStatement = decltype(std::declval<Storage &>().prepare(sqlite_orm::update(Drink{})));
+
+    Storage &storage;
+    std::size_t batch_size;
+    std::size_t pending_writes {0};
+    bool in_transaction {false};
+    // Prepared statements finalize on destruction and must never be copied, so they live on the heap
+    std::unique_ptr<InsertStatement> insert_statement;
+    std::unique_ptr<UpdateStatement> update_statement;
+
+    void begin_batch();
+    void end_write();
+    void rollback_batch();
+};
+
+
+#endif //BUZZBOT_DRINK_WRITER_H
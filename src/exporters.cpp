@@ -13,11 +13,29 @@
  *
 */
 
-void exporters::to_csv(const std::vector<Drink> &drinks, const std::string &path, const std::string& units) {
+static std::string quote(const std::string &field) {
     /*
-     * Creates a CSV file containing the current DB contents.
-     * @param drinks: A vector of Drinks.
-     * @param get_db_path: Path where CSV should be saved.
+     * Wrap a field in quotes, doubling any quotes inside it so the CSV can be read back.
+     */
+
+    std::string quoted {'"'};
+    for (const char c : field) {
+        if (c == '"') {
+            quoted += '"';
+        }
+        quoted += c;
+    }
+    quoted += '"';
+    return quoted;
+}
+
+void exporters::to_csv(Storage &storage, const std::string &path, const std::string& units) {
+    /*
+     * Creates a CSV file containing the current DB contents. Drinks are streamed from the database and written one row
+     * at a time, in date order, so the size of the log doesn't matter.
+     * @param storage: A storage instance.
+     * @param path: Path where CSV should be saved.
+     * @param units: "Metric" to write sizes in ml.
      */
 
     std::ofstream output_csv(path);
@@ -40,15 +58,15 @@ void exporters::to_csv(const std::vector<Drink> &drinks, const std::string &path
     output_csv << "Timestamp,";
     output_csv << "ID\n";
 
-    for (const auto& drink : drinks) {
+    Database::for_each(storage, [&output_csv, &units](const Drink &drink) {
         const std::string ibu = (drink.get_ibu() == -1) ? "" : std::to_string(drink.get_ibu());
         const std::string vintage = (drink.get_vintage() == -999) ? "" : std::to_string(drink.get_vintage());
 
-        const std::string drink_name = '"' + drink.get_name() + '"';
-        const std::string drink_type = '"' + drink.get_type() + '"';
-        const std::string drink_subtype = '"' + drink.get_subtype() + '"';
-        const std::string drink_producer = '"' + drink.get_producer() + '"';
-        const std::string drink_notes = '"' + drink.get_notes() + '"';
+        const std::string drink_name = quote(drink.get_name());
+        const std::string drink_type = quote(drink.get_type());
+        const std::string drink_subtype = quote(drink.get_subtype());
+        const std::string drink_producer = quote(drink.get_producer());
+        const std::string drink_notes = quote(drink.get_notes());
 
         // Convert size to ml if metric option is selected
         const std::string size = (units == "Metric") ? std::to_string(Calculate::oz_to_ml(drink.get_size())) :
@@ -68,7 +86,7 @@ void exporters::to_csv(const std::vector<Drink> &drinks, const std::string &path
         output_csv << drink.get_alcohol_type() + ",";
         output_csv << drink.get_timestamp() + ",";
         output_csv << std::to_string(drink.get_id()) + "\n";
-    }
+    });
 
     output_csv.close();
 }
\ No newline at end of file
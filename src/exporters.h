@@ -9,7 +9,7 @@
 
 class exporters {
 public:
-    static void to_csv(const std::vector<Drink>& drinks, const std::string& path, const std::string& units);
+    static void to_csv(Storage &storage, const std::string& path, const std::string& units);
 };
 
 
@@ -0,0 +1,186 @@
+#include "filter_dictionary.h"
+#include "sqlite_statement.h"
+#include <algorithm>
+#include <stdexcept>
+
+std::vector<std::string> FilterDictionary::values(Storage &storage, const DrinkColumn column) {
+    /*
+     * Get the values to offer for a column, reading them from the database if this is the first time.
+     * @param storage: A storage instance.
+     * @param column: Name, Type, Subtype, Producer or Rating.
+     * @return: The values in the order the filter box shows them. Names made by more than one producer are given as
+     * "Name -- (Producer)". Empty subtypes are left out, and ratings run from highest to lowest.
+     */
+
+    load(storage, column);
+
+    std::vector<std::string> result;
+    if (column == DrinkColumn::Name) {
+        for (const auto &[name, producers] : name_producers) {
+            if (producers.size() == 1) {
+                result.push_back(name);
+                continue;
+            }
+            for (const auto &producer : producers) {
+                result.push_back(producer.first.empty() ? name : name + " -- (" + producer.first + ")");
+            }
+        }
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        return result;
+    }
+
+    const Counts &counts {columns.at(column)};
+    result.reserve(counts.size());
+    for (const auto &entry : counts) {
+        if (column == DrinkColumn::Subtype && entry.first.empty()) {
+            continue;
+        }
+        result.push_back(entry.first);
+    }
+    if (column == DrinkColumn::Rating) {
+        std::sort(result.begin(), result.end(), [](const std::string &a, const std::string &b) {
+            return std::stoi(a) > std::stoi(b);
+        });
+    }
+    return result;
+}
+
+void FilterDictionary::invalidate() {
+    /*
+     * Drop every column, e.g. after drinks were written without going through the dictionary. Each is read again the
+     * next time it's asked for.
+     */
+
+    columns.clear();
+    name_producers.clear();
+    names_loaded = false;
+}
+
+bool FilterDictionary::loaded(const DrinkColumn column) const {
+    /*
+     * Whether a column's values are held, so asking for them won't read the database.
+     */
+
+    return column == DrinkColumn::Name ? names_loaded : columns.count(column) > 0;
+}
+
+void FilterDictionary::add(const Drink &drink) {
+    /*
+     * Count the values of a newly written drink in every loaded column.
+     */
+
+    apply(drink, 1);
+}
+
+void FilterDictionary::remove(const Drink &drink) {
+    /*
+     * Uncount the values of a deleted drink. A value no drink has any more is dropped.
+     */
+
+    apply(drink, -1);
+}
+
+void FilterDictionary::replace(const Drink &old_drink, const Drink &new_drink) {
+    /*
+     * Swap an updated drink's old values for its new ones.
+     * @param old_drink: The drink as it was stored before the update.
+     * @param new_drink: The drink as written.
+     */
+
+    apply(old_drink, -1);
+    apply(new_drink, 1);
+}
+
+void FilterDictionary::load(Storage &storage, const DrinkColumn column) {
+    /*
+     * Read a column's distinct values and their counts, unless they're already held. If the read fails, nothing is
+     * held for the column and this throws.
+     */
+
+    if (loaded(column)) {
+        return;
+    }
+
+    auto connection = Database::connection(storage);
+    if (column == DrinkColumn::Name) {
+        const Statement statement {prepare_statement(connection.get(), "SELECT drink_name, producer, COUNT(*) FROM "
+                                                                       "drinks GROUP BY drink_name, producer")};
+        int rc;
+        while ((rc = sqlite3_step(statement.get())) == SQLITE_ROW) {
+            name_producers[column_text(statement.get(), 0)][column_text(statement.get(), 1)] =
+                    sqlite3_column_int(statement.get(), 2);
+        }
+        if (rc != SQLITE_DONE) {
+            name_producers.clear();
+            throw std::runtime_error(std::string("Failed to read drink names: ") + sqlite3_errmsg(connection.get()));
+        }
+        names_loaded = true;
+        return;
+    }
+
+    const std::string name {column_name(column)};
+    const Statement statement {prepare_statement(connection.get(), "SELECT " + name + ", COUNT(*) FROM drinks "
+                                                                   "GROUP BY " + name)};
+    Counts &counts {columns[column]};
+    int rc;
+    while ((rc = sqlite3_step(statement.get())) == SQLITE_ROW) {
+        counts[column_text(statement.get(), 0)] = sqlite3_column_int(statement.get(), 1);
+    }
+    if (rc != SQLITE_DONE) {
+        columns.erase(column);
+        throw std::runtime_error("Failed to read " + name + " values: " + sqlite3_errmsg(connection.get()));
+    }
+}
+
+void FilterDictionary::apply(const Drink &drink, const int sign) {
+    /*
+     * Count, or uncount, one drink's values in every loaded column.
+     * @param sign: 1 to add the drink, -1 to remove it.
+     */
+
+    if (names_loaded) {
+        count(name_producers[drink.get_name()], drink.get_producer(), sign);
+        if (name_producers[drink.get_name()].empty()) {
+            name_producers.erase(drink.get_name());
+        }
+    }
+    for (auto &[column, counts] : columns) {
+        count(counts, value_of(drink, column), sign);
+    }
+}
+
+void FilterDictionary::count(Counts &counts, const std::string &value, const int sign) {
+    /*
+     * Add sign to a value's count, dropping it once no drink has it.
+     */
+
+    const int value_count {counts[value] += sign};
+    if (value_count <= 0) {
+        counts.erase(value);
+    }
+}
+
+const char *FilterDictionary::column_name(const DrinkColumn column) {
+    switch (column) {
+        case DrinkColumn::Type: return "drink_type";
+        case DrinkColumn::Subtype: return "drink_subtype";
+        case DrinkColumn::Producer: return "producer";
+        case DrinkColumn::Rating: return "rating";
+        default: throw std::invalid_argument("The table can't be filtered on this column");
+    }
+}
+
+std::string FilterDictionary::value_of(const Drink &drink, const DrinkColumn column) {
+    /*
+     * A drink's value in a column, as the grouped query reads it.
+     */
+
+    switch (column) {
+        case DrinkColumn::Type: return drink.get_type();
+        case DrinkColumn::Subtype: return drink.get_subtype();
+        case DrinkColumn::Producer: return drink.get_producer();
+        case DrinkColumn::Rating: return std::to_string(drink.get_rating());
+        default: throw std::invalid_argument("The table can't be filtered on this column");
+    }
+}
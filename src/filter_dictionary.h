@@ -0,0 +1,42 @@
+#ifndef BUZZBOT_FILTER_DICTIONARY_H
+#define BUZZBOT_FILTER_DICTIONARY_H
+
+#include "database.h"
+#include "drink_query.h"
+#include <map>
+#include <string>
+#include <vector>
+
+class FilterDictionary {
+    /*
+     * The distinct values offered by the table filter, per column, each with the number of drinks that have it. A
+     * column is read with one grouped query the first time it's asked for, then kept current by applying each insert,
+     * update and delete as a delta, so switching filter category costs the number of distinct values, not of drinks.
+     * Names are kept per producer, so a name made by more than one producer can be offered once per producer.
+     */
+
+public:
+    std::vector<std::string> values(Storage &storage, DrinkColumn column);
+    void invalidate();
+    [[nodiscard]] bool loaded(DrinkColumn column) const;
+
+    void add(const Drink &drink);
+    void remove(const Drink &drink);
+    void replace(const Drink &old_drink, const Drink &new_drink);
+
+private:
+    using Counts = std::map<std::string, int>;
+
+    std::map<DrinkColumn, Counts> columns;  // Type, subtype, producer and rating, once loaded
+    std::map<std::string, Counts> name_producers;  // Producer counts per name
+    bool names_loaded {false};
+
+    void load(Storage &storage, DrinkColumn column);
+    void apply(const Drink &drink, int sign);
+    static void count(Counts &counts, const std::string &value, int sign);
+    static const char *column_name(DrinkColumn column);
+    static std::string value_of(const Drink &drink, DrinkColumn column);
+};
+
+
+#endif //BUZZBOT_FILTER_DICTIONARY_H
@@ -3,94 +3,33 @@
 //
 
 #include "mainwindow.h"
-#include <iostream>
-
-std::vector<std::set<QString>> MainWindow::generate_filter_item_sets() {
-    /*
-     * Generate sets containing unique filter values.
-     * @return filter_values: A vector of sets containing unique values to pass to the filter dropdown.
-     */
-
-    std::vector<std::set<QString>> filter_values;
-
-    std::set<QString> drink_names;
-    std::set<QString> drink_types;
-    std::set<QString> drink_subtypes;
-    std::set<QString> producers;
-    std::set<QString> ratings;
-
-    ui->filterTextInput->clear();
-
-    // This fixes crashes when changing filters with rows selected.
-    QSignalBlocker filterTextInputSignalBlocker(ui->filterTextInput);
-
-    // Add items to the sets
-    std::vector<Drink> all_drinks = Database::read(storage);
-    rename_duplicate_drink_names(all_drinks);
-    for (const auto& drink : all_drinks) {
-        const QString drink_name = QString::fromStdString(drink.get_name());
-        const QString drink_type = QString::fromStdString(drink.get_type());
-        const QString drink_subtype = QString::fromStdString(drink.get_subtype());
-        const QString producer = QString::fromStdString(drink.get_producer());
-        const QString rating = QString::fromStdString(std::to_string(drink.get_rating()));
-
-        drink_names.insert(drink_name);
-        drink_types.insert(drink_type);
-        drink_subtypes.insert(drink_subtype);
-        producers.insert(producer);
-        ratings.insert(rating);
-    }
-    filter_values.push_back(drink_names);
-    filter_values.push_back(drink_types);
-    filter_values.push_back(drink_subtypes);
-    filter_values.push_back(producers);
-    filter_values.push_back(ratings);
-
-    return filter_values;
-}
+#include <map>
 
 void MainWindow::populate_filter_menus(const std::string& filter_type) {
     /*
-     * Populate the filter menus depending on user selection.
+     * Populate the filter menus depending on user selection. The values come from the repository's filter values,
+     * which read each column once and are kept current as drinks are written, so this doesn't read every drink.
      * @param filter type: Type of filter to use. Options in drink name (name), drink type (type) and producer.
      */
 
-    const std::vector<std::set<QString>> filter_values = generate_filter_item_sets();
+    static const std::map<std::string, DrinkColumn> filter_columns {
+            {"Name", DrinkColumn::Name}, {"Type", DrinkColumn::Type}, {"Subtype", DrinkColumn::Subtype},
+            {"Producer", DrinkColumn::Producer}, {"Rating", DrinkColumn::Rating}};
 
-    if (filter_type == "Name") {
-        for (const auto& name : filter_values.at(0)) {
-            ui->filterTextInput->addItem(name);
-        }
-    } else if (filter_type == "Type") {
-        for (const auto& type : filter_values.at(1)) {
-            ui->filterTextInput->addItem(type);
-        }
-    } else if (filter_type == "Subtype") {
-        for (const auto& subtype : filter_values.at(2)) {
-            if (!subtype.isEmpty()) {
-                ui->filterTextInput->addItem(subtype);
-            }
-        }
-    } else if (filter_type == "Producer") {
-        for (const auto& brewery : filter_values.at(3)) {
-            ui->filterTextInput->addItem(brewery);
-        }
-    } else if (filter_type == "Rating") {
-        // Convert rating integers to QStrings and put in set
-        std::vector<int> ratings_tmp;
-        for (const auto& rating_value : filter_values.at(4)) {
-            const int rating_int = std::stoi(rating_value.toStdString());
-            ratings_tmp.push_back(rating_int);
+    QStringList filter_values;
+    const auto column {filter_columns.find(filter_type)};
+    if (column != filter_columns.end()) {
+        for (const auto& value : repository.filters().values(storage, column->second)) {
+            filter_values.append(QString::fromStdString(value));
         }
+    }
 
-        // Sort ratings in descending order
-        std::sort(ratings_tmp.begin(), ratings_tmp.end(), std::greater<>());
+    // This fixes crashes when changing filters with rows selected.
+    QSignalBlocker filterTextInputSignalBlocker(ui->filterTextInput);
 
-        for (const auto& rating : ratings_tmp) {
-            const QString rating_qstring = QString::fromStdString(std::to_string(rating));
-            ui->filterTextInput->addItem(rating_qstring);
-        }
-    }
+    // Swap the whole list in at once, rather than adding the items one by one
+    filter_text_model->setStringList(filter_values);
+    ui->filterTextInput->setCurrentIndex(filter_values.isEmpty() ? -1 : 0);
 }
 
 void MainWindow::enable_filter_text(const QString&) {
@@ -5,14 +5,17 @@
 #include "graphing.h"
 #include "include/qcustomplot.h"
 #include "calculate.h"
+#include "civil_date.h"
+#include "drink_query.h"
 #include <iostream>
-#include <chrono>
-#include <ctime>
 #include <algorithm>
+#include <limits>
 
-Graphing::Graphing(const std::vector<Drink>& all_drinks, double std_drink_size, const Options& options) {
+Graphing::Graphing(const std::string& in_db_path, double in_std_drink_size, const Options& in_options) :
+        std_drink_size(in_std_drink_size), options(in_options) {
     /*
      * Main graphing window.
+     * @param in_db_path: Database to read drinks from. The loader thread opens its own connection to it.
      */
 
     ui.setupUi(this);
@@ -20,115 +23,377 @@ Graphing::Graphing(const std::vector<Drink>& all_drinks, double std_drink_size,
 
     int window_width {512};
     int window_height {512};
-
-    bool no_beers {true};
+    int controls_height {30};  // Room for the boxes above the plots
 
     this->setFixedWidth(window_width);
-    this->setFixedHeight(window_height);
-
-    //Plot the IBU plot
-    const std::vector ibus {GraphingCalculations::get_beer_ibus(all_drinks)};
-
-    if (!ibus.empty()) {
-        no_beers = false;
-        const std::map<double, size_t> ibu_counts {GraphingCalculations::count_values_in_vect(ibus)};
-        auto ibu_plot {Graphing::plot_ibus(ibu_counts, this)};
-        ibu_plot->setAttribute(Qt::WA_DeleteOnClose);  // Delete pointer on window close
-        ibu_plot->setGeometry(0, 0, window_width, window_height/2);
-        ibu_plot->show();
+    this->setFixedHeight(window_height + controls_height);
+
+    distribution_plot_geometry = QRect(0, controls_height, window_width, window_height/2);
+    abv_plot_geometry = QRect(0, controls_height + window_height/2 + 2, window_width, window_height/2);
+    full_plot_geometry = QRect(0, controls_height, window_width, window_height);
+
+    // Placeholders until the loader delivers. The boxes stay disabled until there's data to regroup.
+    distribution_plot = Graphing::plot_message("Distribution", "Loading drinks...", this);
+    distribution_plot->setGeometry(distribution_plot_geometry);
+    distribution_plot->show();
+    abv_plot = Graphing::plot_message("Alcohol Consumption Over Time", "Loading drinks...", this);
+    abv_plot->setGeometry(abv_plot_geometry);
+    abv_plot->show();
+    ui.granularityComboBox->setEnabled(false);
+    ui.distributionComboBox->setEnabled(false);
+    ui.binsComboBox->setEnabled(false);
+
+    connect(ui.granularityComboBox, &QComboBox::currentIndexChanged, this, &Graphing::changed_granularity);
+    connect(ui.distributionComboBox, &QComboBox::currentIndexChanged, this, &Graphing::show_distribution_plot);
+    connect(ui.binsComboBox, &QComboBox::currentIndexChanged, this, &Graphing::show_distribution_plot);
+
+    loader = std::thread(&Graphing::load_drinks, this, in_db_path,
+                         static_cast<TimeGranularity>(ui.granularityComboBox->currentIndex()),
+                         static_cast<HistogramMetric>(ui.distributionComboBox->currentIndex()),
+                         ui.binsComboBox->currentIndex() == 1);
+}
+
+Graphing::~Graphing() {
+    /*
+     * Cancel loading, and wait for the loader so it can't hand results to a deleted window. A query in progress
+     * is interrupted by the loader's progress handler, so this doesn't wait for it to finish. Results already posted
+     * are discarded with the window.
+     */
+
+    cancelled = true;
+    if (loader.joinable()) {
+        loader.join();
     }
+}
+
+void Graphing::load_drinks(const std::string& db_path, const TimeGranularity granularity, HistogramMetric metric,
+                           const bool deciles) {
+    /*
+     * Runs on the loader thread. Build the consumption over time data from the daily totals, then read the drinks
+     * for the distribution, handing each to the GUI thread as soon as it's ready. Once the window is closed, stops
+     * between steps, and a query in progress is interrupted.
+     * @param db_path: Database to read from, through a connection of the loader's own.
+     * @param granularity: Bucket size picked when the window opened.
+     * @param metric: Distribution picked when the window opened. ABV is used instead of IBU if there are no IBUs.
+     * @param deciles: True for decile bins, false for fixed width.
+     */
+
+    try {
+        Storage loader_storage {initStorage(db_path)};
+        loader_storage.open_forever();  // Keep the connection the progress handler is registered on
+        sqlite3_progress_handler(Database::connection(loader_storage).get(), 1000, [](void *flag) {
+            return static_cast<std::atomic<bool> *>(flag)->load() ? 1 : 0;  // Nonzero interrupts the query
+        }, &cancelled);
+        // One row per day and alcohol type, kept current by triggers, so this doesn't scale with the drinks
+        const auto totals {std::make_shared<const std::vector<DailyTotal>>(
+                Database::daily_totals(loader_storage, std::numeric_limits<int>::min(),
+                                       std::numeric_limits<int>::max()))};
+        if (cancelled) {
+            return;
+        }
+
+        const QVector<QCPGraphData> time_data {Graphing::time_data_aggregator(
+                GraphingCalculations::bucket_daily_totals(*totals, std_drink_size, granularity))};
+        if (cancelled) {
+            return;
+        }
+        QMetaObject::invokeMethod(this, [this, totals, time_data, granularity]() {
+            daily_totals = totals;
+            if (daily_totals->empty()) {  // Full size plot if there's nothing to show a distribution of
+                delete distribution_plot;
+                distribution_plot = nullptr;
+                abv_plot_geometry = full_plot_geometry;
+            }
+            set_abv_plot(time_data, granularity);
+            ui.granularityComboBox->setEnabled(true);
+        }, Qt::QueuedConnection);
 
-    // Plot the ABV plot
-    QVector<QCPGraphData> time_data;
-    if (!all_drinks.empty()) {
-        time_data = Graphing::time_data_aggregator(all_drinks, std_drink_size);
+        if (totals->empty()) {
+            return;
+        }
+        const auto all_drinks {std::make_shared<const std::vector<DrinkFacts>>(DrinkQuery().facts(loader_storage))};
+        if (cancelled) {
+            return;
+        }
+        if (metric == HistogramMetric::Ibu && GraphingCalculations::get_beer_ibus(*all_drinks).empty()) {
+            metric = HistogramMetric::Abv;
+        }
+        const DistributionPlot plot {Graphing::distribution(*all_drinks, metric, deciles, std_drink_size,
+                                                            options.units)};
+        if (cancelled) {
+            return;
+        }
+        QMetaObject::invokeMethod(this, [this, all_drinks, plot, metric]() {
+            drinks = all_drinks;
+            const QSignalBlocker blocker(ui.distributionComboBox);  // Already plotted, don't plot again
+            ui.distributionComboBox->setCurrentIndex(static_cast<int>(metric));
+            set_distribution_plot(plot);
+            ui.distributionComboBox->setEnabled(true);
+            ui.binsComboBox->setEnabled(true);
+        }, Qt::QueuedConnection);
+    } catch (const std::exception &error) {
+        if (cancelled) {  // Interrupted because the window closed
+            return;
+        }
+        std::cerr << "Failed to load drinks for graphs: " << error.what() << std::endl;
+        QMetaObject::invokeMethod(this, [this]() {
+            daily_totals = nullptr;
+            ui.granularityComboBox->setEnabled(false);
+            if (distribution_plot) {
+                delete distribution_plot;
+                distribution_plot = Graphing::plot_message("Distribution", "Could not read drinks", this);
+                distribution_plot->setGeometry(distribution_plot_geometry);
+                distribution_plot->show();
+            }
+            delete abv_plot;
+            abv_plot = Graphing::plot_message("Alcohol Consumption Over Time", "Could not read drinks", this);
+            abv_plot->setGeometry(abv_plot_geometry);
+            abv_plot->show();
+        }, Qt::QueuedConnection);
     }
+}
 
-    auto abv_plot {Graphing::plot_abvs(time_data, options, this)};
+void Graphing::changed_granularity() {
+    /*
+     * Re-plot consumption over time when the user picks another bucket size.
+     */
 
-    if (no_beers) {  // Full size plot if beer data is empty
-        abv_plot->setGeometry(0, 0, window_width, window_height);
+    show_abv_plot(static_cast<TimeGranularity>(ui.granularityComboBox->currentIndex()));
+}
+
+void Graphing::show_abv_plot(const TimeGranularity granularity) {
+    /*
+     * Replace the consumption over time plot with one summed by granularity.
+     * @param granularity: Whether to sum standard drinks by day, week, month or year.
+     */
+
+    if (!daily_totals) {
+        return;
+    }
+    set_abv_plot(Graphing::time_data_aggregator(GraphingCalculations::bucket_daily_totals(*daily_totals,
+                                                                                         std_drink_size, granularity)),
+                 granularity);
+}
+
+void Graphing::set_abv_plot(const QVector<QCPGraphData>& time_data, const TimeGranularity granularity) {
+    /*
+     * Replace the consumption over time plot.
+     * @param time_data: Standard drinks per bucket, from time_data_aggregator.
+     * @param granularity: What each point sums.
+     */
+
+    delete abv_plot;
+    abv_plot = Graphing::plot_abvs(time_data, granularity, options, this);
+    abv_plot->setGeometry(abv_plot_geometry);
+
+    if (abv_plot->graphCount() > 0) {
+        // Zoom and pan along the time axis, drawing from the pyramid level that matches the visible range
+        std::vector<double> keys;
+        std::vector<double> values;
+        keys.reserve(static_cast<std::size_t>(time_data.size()));
+        values.reserve(static_cast<std::size_t>(time_data.size()));
+        for (const QCPGraphData &data : time_data) {
+            keys.push_back(data.key);
+            values.push_back(data.value);
+        }
+        abv_lod = LodPyramid(keys, values);
+
+        abv_plot->setInteractions(QCP::iRangeDrag | QCP::iRangeZoom);
+        abv_plot->axisRect()->setRangeDrag(Qt::Horizontal);
+        abv_plot->axisRect()->setRangeZoom(Qt::Horizontal);
+        connect(abv_plot->xAxis, QOverload<const QCPRange &>::of(&QCPAxis::rangeChanged), this,
+                &Graphing::changed_abv_range);
+        abv_plot->show();
+        changed_abv_range(abv_plot->xAxis->range());
     } else {
-        abv_plot->setGeometry(0, (window_height/2+2), window_width, window_height/2);
+        abv_lod = LodPyramid();
+        abv_plot->show();
     }
-    abv_plot->show();
 }
 
-QCustomPlot * Graphing::plot_ibus(const std::map<double, size_t>& ibu_counts, QDialog *parent) {
+void Graphing::changed_abv_range(const QCPRange &range) {
     /*
-     * Plot IBU values in QCustomPlot
-     * @param parent: The window that the graph should appear in.
-     * @param ibu_counts: a map<double, int> of ibu values (keys) and their counts (values).
+     * Swap the consumption plot's data for the level of detail matching the visible range and plot width. Each
+     * point of a coarser level is drawn as its min and its max, so peaks survive decimation.
+     * @param range: The visible range of the time axis.
      */
 
-    auto *ibu_plot {new QCustomPlot(parent)};
-    ibu_plot->setAttribute(Qt::WA_DeleteOnClose);
+    const int pixel_width {abv_plot->axisRect()->width()};
+    const std::vector<LodPoint> points {abv_lod.visible(range.lower, range.upper, pixel_width)};
+    const bool raw {abv_lod.level_for(range.lower, range.upper, pixel_width) == 0};
 
-    // Add title
-    // add title layout element:
-    ibu_plot->plotLayout()->insertRow(0);
-    ibu_plot->plotLayout()->addElement(0, 0,
-                                       new QCPTextElement(ibu_plot, "Beer IBU Distribution",
-                                                          QFont("Helvetica Neue", 12,
-                                                                QFont::Bold)));
-
-    QVector<double> ibus(static_cast<qsizetype>(ibu_counts.size()));
-    QVector<double> percentages(static_cast<qsizetype>(ibu_counts.size()));
-    size_t total_drinks {0};
-
-    // Build vectors
-
-    // Get total count of drinks
-    for (auto const& [ibu, count] : ibu_counts) {  //Pragma to ignore unused var is for this line
-        if (ibu >= 0) {
-            total_drinks += count;
+    QVector<QCPGraphData> lod_data(static_cast<qsizetype>(raw ? points.size() : points.size() * 2));
+    qsizetype i {0};
+    for (const LodPoint &point : points) {
+        if (raw) {
+            lod_data[i++] = QCPGraphData(point.key, point.max);
+        } else {
+            lod_data[i++] = QCPGraphData(point.key, point.min);
+            lod_data[i++] = QCPGraphData(point.last_key, point.max);
         }
     }
 
-    int i = 0;
-    for (auto const& [key, val] : ibu_counts) {
-        if (key >= 0) {
-            ibus[i] = key;
-            //counts[i] = val;
-            percentages[i] = (static_cast<double>(val) / static_cast<double>(total_drinks)) * 100;
-            i++;
-        }
+    abv_plot->graph(0)->data()->set(lod_data, true);
+    abv_plot->replot(QCustomPlot::rpQueuedReplot);
+}
+
+void Graphing::show_distribution_plot() {
+    /*
+     * Replace the distribution plot with the metric and binning picked in the boxes above the plots.
+     */
+
+    if (!drinks || drinks->empty()) {
+        return;
     }
+    set_distribution_plot(Graphing::distribution(*drinks,
+                                                 static_cast<HistogramMetric>(ui.distributionComboBox->currentIndex()),
+                                                 ui.binsComboBox->currentIndex() == 1, std_drink_size, options.units));
+}
 
-    // Get min/max values for axes
-    const double ibu_min {*std::min_element(ibus.begin(), ibus.end())};
-    const double ibu_max {*std::max_element(ibus.begin(), ibus.end())};
-    const double perc_min {*std::min_element(percentages.begin(), percentages.end())};
-    const double perc_max {*std::max_element(percentages.begin(), percentages.end())};
+void Graphing::set_distribution_plot(const DistributionPlot& distribution) {
+    /*
+     * Replace the distribution plot.
+     */
 
-    // Graph style
-    QPen drawPen;
-    drawPen.setColor(Qt::black);
-    drawPen.setStyle(Qt::PenStyle::SolidLine);
-    drawPen.setWidth(2);
+    delete distribution_plot;
+    distribution_plot = Graphing::plot_histogram(distribution, this);
+    distribution_plot->setGeometry(distribution_plot_geometry);
+    distribution_plot->show();
+}
+
+DistributionPlot Graphing::distribution(const std::vector<DrinkFacts>& all_drinks, const HistogramMetric metric,
+                                        const bool deciles, const double std_drink_size, const std::string& units) {
+    /*
+     * Bin one metric of the drinks, and label it. Safe to call off the GUI thread.
+     * @param metric: What to show the distribution of.
+     * @param deciles: True for decile bins, false for the metric's fixed width.
+     * @param units: "Metric" to show sizes in ml.
+     */
+
+    std::vector<double> values {Histograms::metric_values(all_drinks, metric, std_drink_size)};
+    double bin_width {Histograms::default_bin_width(metric)};
+    auto limits {Histograms::plausible_range(metric)};
+    DistributionPlot plot;
+    plot.y_label = "% of All Drinks";
+    switch (metric) {
+        case HistogramMetric::Ibu:
+            plot.title = "Beer IBU Distribution";
+            plot.x_label = "IBU";
+            break;
+        case HistogramMetric::Abv:
+            plot.title = "ABV Distribution";
+            plot.x_label = "ABV (%)";
+            break;
+        case HistogramMetric::Size:
+            plot.title = "Drink Size Distribution";
+            plot.x_label = "Size (oz.)";
+            if (units == "Metric") {
+                // Everything is stored in DB as oz. Convert to ml for display.
+                std::transform(values.begin(), values.end(), values.begin(), Calculate::oz_to_ml);
+                bin_width = 30;
+                limits = {Calculate::oz_to_ml(limits.first), Calculate::oz_to_ml(limits.second)};
+                plot.x_label = "Size (ml)";
+            }
+            break;
+        case HistogramMetric::Rating:
+            plot.title = "Rating Distribution";
+            plot.x_label = "Rating";
+            break;
+        case HistogramMetric::StdDrinksPerDay:
+            plot.title = "Std. Drinks per Drinking Day";
+            plot.x_label = "Std. Drinks";
+            plot.y_label = "% of Drinking Days";
+            break;
+    }
+
+    plot.unequal_bins = deciles;
+    plot.histogram = deciles ? Histograms::quantiles(std::move(values), 10)
+                             : Histograms::fixed_width(values, bin_width, limits);
+    return plot;
+}
+
+QCustomPlot * Graphing::plot_histogram(const DistributionPlot& distribution, QDialog *parent) {
+    /*
+     * Plot a histogram in QCustomPlot, as the percentage of values in each bin.
+     * @param distribution: The bins to plot and their labels. If bins differ in width, e.g. quantile bins, each bin is
+     * drawn as percent per unit on the x axis, so its area rather than its height shows its share of the values.
+     * @param parent: The window that the graph should appear in.
+     */
+
+    const Histogram &histogram {distribution.histogram};
+
+    auto *histogram_plot {new QCustomPlot(parent)};
+    histogram_plot->setAttribute(Qt::WA_DeleteOnClose);
+
+    // Add title
+    histogram_plot->plotLayout()->insertRow(0);
+    histogram_plot->plotLayout()->addElement(0, 0,
+                                             new QCPTextElement(histogram_plot, QString::fromStdString(distribution.title),
+                                                                QFont("Helvetica Neue", 12, QFont::Bold)));
+
+    if (histogram.total == 0) {
+        add_message(histogram_plot, "Not enough data to plot");
+        histogram_plot->replot();
+        return histogram_plot;
+    }
 
     const QColor color(120,77, 150, 150);
+    const auto bin_count {static_cast<qsizetype>(histogram.bins.size())};
+    double max_percentage {0};
+
+    if (distribution.unequal_bins) {
+        // Step line from each bin's lower edge, with a closing point at the last bin's upper edge
+        QVector<double> edges(bin_count + 1);
+        QVector<double> densities(bin_count + 1);
+        for (qsizetype i {0}; i < bin_count; i++) {
+            const HistogramBin &bin {histogram.bins[static_cast<std::size_t>(i)]};
+            const double percentage {static_cast<double>(bin.count) / static_cast<double>(histogram.total) * 100};
+            const double width {bin.upper - bin.lower};
+            edges[i] = bin.lower;
+            densities[i] = width > 0 ? percentage / width : percentage;
+            max_percentage = std::max(max_percentage, densities[i]);
+        }
+        edges[bin_count] = histogram.bins.back().upper;
+        densities[bin_count] = densities[bin_count - 1];
+
+        histogram_plot->addGraph();
+        histogram_plot->graph()->setData(edges, densities, true);
+        histogram_plot->graph()->setLineStyle(QCPGraph::lsStepLeft);
+        histogram_plot->graph()->setPen(QPen(color.darker(200)));
+        histogram_plot->graph()->setBrush(QBrush(color));
+        histogram_plot->yAxis->setLabel(QString::fromStdString(distribution.y_label + " per Unit"));
+    } else {
+        QVector<double> centers(bin_count);
+        QVector<double> percentages(bin_count);
+        for (qsizetype i {0}; i < bin_count; i++) {
+            const HistogramBin &bin {histogram.bins[static_cast<std::size_t>(i)]};
+            centers[i] = (bin.lower + bin.upper) / 2;
+            percentages[i] = static_cast<double>(bin.count) / static_cast<double>(histogram.total) * 100;
+            max_percentage = std::max(max_percentage, percentages[i]);
+        }
 
-    // Create the IBU graph
-    ibu_plot->addGraph();
-    ibu_plot->graph(0)->setData(ibus, percentages);
-    ibu_plot->graph()->setPen(drawPen);
-    ibu_plot->xAxis->setLabel("IBU");
-    ibu_plot->yAxis->setLabel("% of All Drinks");
-    ibu_plot->xAxis->setRange(ibu_min, ibu_max);
-    ibu_plot->yAxis->setRange(perc_min, perc_max);
-    ibu_plot->graph()->setLineStyle(QCPGraph::lsLine);
-    ibu_plot->graph()->setPen(QPen(color.darker(200)));
-    ibu_plot->graph()->setBrush(QBrush(color));
-    ibu_plot->replot();
-
-    return ibu_plot;
+        auto *bars {new QCPBars(histogram_plot->xAxis, histogram_plot->yAxis)};
+        bars->setWidth(histogram.bins.front().upper - histogram.bins.front().lower);
+        bars->setData(centers, percentages, true);
+        bars->setPen(QPen(color.darker(200)));
+        bars->setBrush(QBrush(color));
+        histogram_plot->yAxis->setLabel(QString::fromStdString(distribution.y_label));
+    }
+
+    histogram_plot->xAxis->setLabel(QString::fromStdString(distribution.x_label));
+    histogram_plot->xAxis->setRange(histogram.bins.front().lower, histogram.bins.back().upper);
+    histogram_plot->yAxis->setRange(0, max_percentage * 1.05);
+    histogram_plot->replot();
+
+    return histogram_plot;
 }
 
-QCustomPlot *Graphing::plot_abvs(const QVector<QCPGraphData>& time_data, const Options& options, QDialog *parent) {
+QCustomPlot *Graphing::plot_abvs(const QVector<QCPGraphData>& time_data, const TimeGranularity granularity,
+                                 const Options& options, QDialog *parent) {
     /*
      * Plot the ABV over time graph.
      * @param time_data: A QVector of QCPGraphData objects.
+     * @param granularity: What each point sums. The weekly limit line is only drawn for weeks.
      */
 
     auto *abv_plot {new QCustomPlot(parent)};
@@ -174,24 +439,29 @@ QCustomPlot *Graphing::plot_abvs(const QVector<QCPGraphData>& time_data, const O
             }
         }
 
-        // Set min drinks to just below limit line if limit is below min drinks
-        if (limit <= min_drinks) {
-            min_drinks = limit - 3;
-            std::cout << "Limit below minimum drinks consumed. "\
-                     "Resetting graph Y-axis to a min of " << min_drinks << std::endl;
-        }
-
         QColor color(70,95, 150, 150);
-        // Set up limit line
-        auto* limit_line {new QCPItemStraightLine(abv_plot)};
-        limit_line->point1->setCoords(min_year, limit);
-        limit_line->point2->setCoords(max_year, limit);
-        limit_line->setPen(QPen(QColor(255, 0, 0)));
+        if (granularity == TimeGranularity::Week) {
+            // Set min drinks to just below limit line if limit is below min drinks
+            if (limit <= min_drinks) {
+                min_drinks = limit - 3;
+                std::cout << "Limit below minimum drinks consumed. "\
+                         "Resetting graph Y-axis to a min of " << min_drinks << std::endl;
+            }
+
+            // Set up limit line
+            auto* limit_line {new QCPItemStraightLine(abv_plot)};
+            limit_line->point1->setCoords(min_year, limit);
+            limit_line->point2->setCoords(max_year, limit);
+            limit_line->setPen(QPen(QColor(255, 0, 0)));
+        }
 
         QSharedPointer<QCPAxisTickerDateTime> dateTicker(new QCPAxisTickerDateTime);
+        dateTicker->setDateTimeSpec(Qt::UTC);  // Bucket keys are midnight UTC
 
-        // Show dates if fewer than 15 weeks of data
-        if (time_data.size() < 15) {
+        // Show dates if fewer than 15 days or weeks of data
+        if (granularity == TimeGranularity::Year) {
+            dateTicker->setDateTimeFormat("yyyy");
+        } else if (time_data.size() < 15 && granularity != TimeGranularity::Month) {
             dateTicker->setDateTimeFormat("d. MMM\nyyyy");
         } else {
             dateTicker->setDateTimeFormat("MMM\nyyyy");
@@ -215,15 +485,7 @@ QCustomPlot *Graphing::plot_abvs(const QVector<QCPGraphData>& time_data, const O
         abv_plot->graph()->setPen(QPen(color.darker(200)));
         abv_plot->graph()->setBrush(QBrush(color));
     } else {
-        auto *no_data_label = new QCPItemText(abv_plot);
-        no_data_label->setPositionAlignment(Qt::AlignTop|Qt::AlignHCenter);
-        no_data_label->position->setType(QCPItemPosition::ptAxisRectRatio);
-        no_data_label->position->setCoords(0.5, .5);
-        no_data_label->setText("Not enough data to plot");
-        no_data_label->setPen(QPen(Qt::black));
-        no_data_label->setPadding(QMargins(2, 2, 2, 2));
-        abv_plot->xAxis->setVisible(false);
-        abv_plot->yAxis->setVisible(false);
+        add_message(abv_plot, "Not enough data to plot");
     }
 
     abv_plot->replot();
@@ -231,106 +493,54 @@ QCustomPlot *Graphing::plot_abvs(const QVector<QCPGraphData>& time_data, const O
     return abv_plot;
 }
 
-void Graphing::add_empty_drinks(const int first_year, const int last_year, const int max_date, const int min_date,
-                                std::map<int, double> &date_std_drinks) {
+QCustomPlot * Graphing::plot_message(const std::string& title, const std::string& message, QDialog *parent) {
     /*
-     * Add empty days to map if no drinks were consumed.
-     * @param first_year: int denoting first year
-     * @param last_year: int denoting last year
-     * @param date_std_drinks: map of dates and std drinks consumed
+     * Create a plot with a title and a message in place of data, e.g. while drinks are loading.
      */
 
-    for (int year {first_year}; year <= last_year; year++) {
-        for (int week_num {0}; week_num <= 51; week_num++) {
-            const std::string year_week_num {std::to_string(year) + '-' + std::to_string(week_num)};
-            const std::string date_str {std::to_string(GraphingCalculations::date_from_week_num(year_week_num))};
-            const int date = GraphingCalculations::parse_date(date_str);
+    auto *message_plot {new QCustomPlot(parent)};
+    message_plot->setAttribute(Qt::WA_DeleteOnClose);
+    message_plot->plotLayout()->insertRow(0);
+    message_plot->plotLayout()->addElement(0, 0,
+                                           new QCPTextElement(message_plot, QString::fromStdString(title),
+                                                              QFont("Helvetica Neue", 12, QFont::Bold)));
+    add_message(message_plot, message);
+    message_plot->replot();
 
-            // Add to vector
-            if (date_std_drinks.find(date) == date_std_drinks.end() && date <= max_date && date >= min_date) {
-                // Date not in date_std_drinks
-                date_std_drinks[date] = 0;
-            }
-        }
-    }
+    return message_plot;
 }
 
-QVector<QCPGraphData> Graphing::create_qvect(const std::map<int, double> &date_std_drinks) {
+void Graphing::add_message(QCustomPlot *plot, const std::string& message) {
     /*
-     * Create QVector of std drinks
+     * Show a message in the middle of a plot, with its axes hidden.
      */
 
-    // Create the QVectof of QCPGraphData objects
-    QVector<QCPGraphData> time_data(static_cast<qsizetype>(date_std_drinks.size()));
-    qsizetype it_value {0};
-    for (auto it {date_std_drinks.begin()}; it != date_std_drinks.end(); it++) {
-        time_data[it_value].key = it->first;
-        time_data[it_value].value = it->second;
-        it_value += 1;
-    }
-
-    return time_data;
+    auto *message_label = new QCPItemText(plot);
+    message_label->setPositionAlignment(Qt::AlignTop|Qt::AlignHCenter);
+    message_label->position->setType(QCPItemPosition::ptAxisRectRatio);
+    message_label->position->setCoords(0.5, .5);
+    message_label->setText(QString::fromStdString(message));
+    message_label->setPen(QPen(Qt::black));
+    message_label->setPadding(QMargins(2, 2, 2, 2));
+    plot->xAxis->setVisible(false);
+    plot->yAxis->setVisible(false);
 }
 
-void Graphing::add_std_drinks(const int date, const double std_drinks, std::map<int, double> &date_std_drinks) {
+QVector<QCPGraphData> Graphing::time_data_aggregator(const TimeSeries &series) {
     /*
-     * Add std drinks to the map of std drinks
-     * @param std_drinks the number of std drinks to add
-     * @param date_std_drinks: The map of std drinks
+     * Creates a QVector of QCPGraphData from a bucketed series, with one point per bucket from the first drink to
+     * the last. Buckets without drinks are zero.
+     * @param series: Standard drinks per bucket, e.g. from GraphingCalculations::bucket_daily_totals.
      */
 
-    if (date_std_drinks.find(date) == date_std_drinks.end()) {
-        // Date not in date_std_drinks
-        date_std_drinks[date] = std_drinks;
-    } else {
-        // Date already processed
-        auto it = date_std_drinks.find(date);
-        it->second += std_drinks;
+    // Allocated once. Keys are each bucket's first day, at midnight UTC.
+    QVector<QCPGraphData> time_data(static_cast<qsizetype>(series.std_drinks.size()));
+    for (qsizetype i {0}; i < time_data.size(); i++) {
+        const int bucket_start {GraphingCalculations::bucket_start_day(series.first_bucket + static_cast<int>(i),
+                                                                       series.granularity)};
+        time_data[i].key = static_cast<double>(civil_date::to_epoch_seconds(bucket_start));
+        time_data[i].value = series.std_drinks[static_cast<std::size_t>(i)];
     }
-}
-
-QVector<QCPGraphData> Graphing::time_data_aggregator(std::vector<Drink> all_drinks, double std_drink_size) {
-    /*
-     * Creates a QVector of QCPGraphData from a vector of Drinks.
-     * @param all_drinks: a vector of Drinks.
-     */
-
-    std::map<int, double> date_std_drinks {};
-    const std::string first_week_string {GraphingCalculations::week_number(std::stoi(all_drinks.at(0).get_date()))};
-    const std::string last_week_string {GraphingCalculations::week_number(std::stoi(all_drinks[all_drinks.size()-1].get_date()))};
-    int min_date {std::numeric_limits<int>::max()}; // Everything is <= this
-    int max_date {std::numeric_limits<int>::min()}; // Everything is >= this
-    const int first_year {std::stoi(first_week_string.substr(0, first_week_string.find('-')))};
-    const int last_year {std::stoi(last_week_string.substr(0, last_week_string.find('-')))};
 
-    // Sort by date
-    std::sort(all_drinks.begin(), all_drinks.end(), GraphingCalculations::compare_by_date);
-
-
-    for (const Drink all_drink : all_drinks) {
-        //date_tmp = parse_date(all_drink.date);
-        std::string date_tmp = all_drink.get_date();
-
-        // Get week number & integer date value from DB date
-        date_tmp.erase(std::remove(date_tmp.begin(), date_tmp.end(), '-'), date_tmp.end());
-        const std::string week_num {GraphingCalculations::week_number(std::stoi(date_tmp))};
-        const std::string date_str {std::to_string(GraphingCalculations::date_from_week_num(week_num))};
-        const int date {GraphingCalculations::parse_date(date_str)};
-
-        // Get min & max dates for graph
-        if (date > max_date) {
-            max_date = date;
-        }
-
-        if (date < min_date) {
-            min_date = date;
-        }
-
-        // Add to the map of dates & std drinks
-        add_std_drinks(date, all_drink.get_standard_drinks(), date_std_drinks);
-    }
-
-    add_empty_drinks(first_year, last_year, max_date, min_date, date_std_drinks);
-
-    return create_qvect(date_std_drinks);
-}
\ No newline at end of file
+    return time_data;
+}
@@ -10,25 +10,63 @@
 #include "mainwindow.h"
 #include "../ui/ui_graph_window.h"
 #include "graphing_calculations.h"
+#include "histogram.h"
+#include "lod_pyramid.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+struct DistributionPlot {
+    Histogram histogram {};
+    bool unequal_bins {false};
+    std::string title;
+    std::string x_label;
+    std::string y_label;
+};
 
 class Graphing : public QDialog, public Ui::GraphWindow {
     /*
-     * About dialog
+     * Graph window. Opens with placeholder plots; the drinks are read and aggregated on a loader thread, and each plot
+     * is drawn as soon as its data arrives.
      */
 
 Q_OBJECT
     Ui::GraphWindow ui{};
 
 public:
-    explicit Graphing(const std::vector<Drink>& all_drinks, double std_drink_size, const Options& options);
-    static QCustomPlot * plot_ibus(const std::map<double, size_t>& ibu_counts, QDialog *parent = nullptr);
-    static QCustomPlot * plot_abvs(const QVector<QCPGraphData>& time_data, const Options& options, QDialog *parent);
+    explicit Graphing(const std::string& in_db_path, double in_std_drink_size, const Options& in_options);
+    ~Graphing() override;
+    static QCustomPlot * plot_histogram(const DistributionPlot& distribution, QDialog *parent = nullptr);
+    static QCustomPlot * plot_abvs(const QVector<QCPGraphData>& time_data, TimeGranularity granularity,
+                                   const Options& options, QDialog *parent);
+    static QCustomPlot * plot_message(const std::string& title, const std::string& message, QDialog *parent);
+private slots:
+    void changed_granularity();
+    void show_distribution_plot();
+    void changed_abv_range(const QCPRange &range);
 private:
-    static void add_empty_drinks(const int first_year, const int last_year, const int max_date, const int min_date,
-    std::map<int, double> &date_std_drinks);
-    static QVector<QCPGraphData> create_qvect(const std::map<int, double> &date_std_drinks);
-    static void add_std_drinks(const int date, const double std_drinks, std::map<int, double> &date_std_drinks);
-    static QVector<QCPGraphData> time_data_aggregator(std::vector<Drink> all_drinks, double std_drink_size);
+    std::shared_ptr<const std::vector<DailyTotal>> daily_totals;  // Null until the loader delivers them
+    std::shared_ptr<const std::vector<DrinkFacts>> drinks;  // For the distribution, delivered after the totals
+    double std_drink_size;
+    Options options;
+    std::atomic<bool> cancelled {false};
+    std::thread loader;
+    QCustomPlot *abv_plot {nullptr};
+    QRect abv_plot_geometry;
+    QRect full_plot_geometry;
+    LodPyramid abv_lod;
+    QCustomPlot *distribution_plot {nullptr};
+    QRect distribution_plot_geometry;
+
+    void load_drinks(const std::string& db_path, TimeGranularity granularity, HistogramMetric metric, bool deciles);
+    void show_abv_plot(TimeGranularity granularity);
+    void set_abv_plot(const QVector<QCPGraphData>& time_data, TimeGranularity granularity);
+    void set_distribution_plot(const DistributionPlot& distribution);
+    static DistributionPlot distribution(const std::vector<DrinkFacts>& all_drinks, HistogramMetric metric,
+                                         bool deciles, double std_drink_size, const std::string& units);
+    static void add_message(QCustomPlot *plot, const std::string& message);
+    static QVector<QCPGraphData> time_data_aggregator(const TimeSeries &series);
 };
 
 
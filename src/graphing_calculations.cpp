@@ -2,11 +2,15 @@
 // Created by rwardrup on 9/19/22.
 //
 
-#include <iomanip>
+#include <algorithm>
 #include <map>
-#include <cstring>
-#include <sstream>
 #include "graphing_calculations.h"
+#include "civil_date.h"
+#include "database.h"
+
+namespace {
+    constexpr int first_monday {civil_date::days_from_civil(1970, 1, 5)};  // Week buckets are counted from here
+}
 
 std::vector<double> GraphingCalculations::get_beer_ibus(const std::vector<Drink>& all_drinks) {
     /*
@@ -43,6 +47,40 @@ std::vector<double> GraphingCalculations::get_drink_abvs(const std::vector<Drink
     return abv_values;
 }
 
+std::vector<double> GraphingCalculations::get_beer_ibus(const std::vector<DrinkFacts>& all_drinks) {
+    /*
+     * Create a vector containing IBU values of all beers.
+     * @param all_drinks: Facts for all drinks in the database.
+     * @return: Vector of doubles representing all beer IBUs.
+     */
+
+    std::vector<double> ibu_values {};
+
+    for (const auto& drink : all_drinks) {
+        if (drink.ibu > 0)  // Exclude non-beer drinks
+            ibu_values.push_back(drink.ibu);
+    }
+
+    return ibu_values;
+}
+
+std::vector<double> GraphingCalculations::get_drink_abvs(const std::vector<DrinkFacts> &all_drinks) {
+    /*
+     * Create a vector containing ABV values of all drinks.
+     * @param all_drinks: Facts for all drinks in the database.
+     * @return: A vector of doubles denoting all drink ABVs.
+     */
+
+    std::vector<double> abv_values {};
+
+    abv_values.reserve(all_drinks.size());
+    for (const auto& drink : all_drinks) {
+        abv_values.push_back(drink.abv);
+    }
+
+    return abv_values;
+}
+
 std::map<double, size_t> GraphingCalculations::count_values_in_vect(const std::vector<double>& all_values) {
     /*
      * Create a map of values and their counts.
@@ -50,97 +88,140 @@ std::map<double, size_t> GraphingCalculations::count_values_in_vect(const std::v
      * @return: a map<double, int> of values (keys) and their counts (values).
      */
 
-    std::vector<double> ibu_copy {all_values};
-    std::map<double, size_t> ibu_counts {};
+    std::vector<double> sorted_values {all_values};
+    std::sort(sorted_values.begin(), sorted_values.end());
 
-    // Get count (y value) of each IBU (x value).
-    // First, get unique items in vector
-    std::sort(ibu_copy.begin(), ibu_copy.end());
-    ibu_copy.erase(unique(ibu_copy.begin(), ibu_copy.end()), ibu_copy.end());
-
-    // Create map where key is the IBU value and value is the count of the IBU in all_values.
-    for (const double &i : ibu_copy) {
-        const double ibu_value = i;
-        size_t ibu_count = std::count(all_values.begin(), all_values.end(), ibu_value);
-        ibu_counts[i] = ibu_count;
+    // Equal values are adjacent once sorted, so count each run and insert at the end of the map
+    std::map<double, size_t> value_counts {};
+    for (auto run_start {sorted_values.begin()}; run_start != sorted_values.end();) {
+        const auto run_end {std::upper_bound(run_start, sorted_values.end(), *run_start)};
+        value_counts.emplace_hint(value_counts.end(), *run_start, static_cast<size_t>(run_end - run_start));
+        run_start = run_end;
     }
 
-    return ibu_counts;
+    return value_counts;
 }
 
-bool GraphingCalculations::compare_by_date(const Drink &a, const Drink &b) {
+int GraphingCalculations::bucket_id(const int day, const TimeGranularity granularity) {
     /*
-     * Compare dates between two drinks.
-     * @return: True if drink a is earlier than drink b. Else, false.
+     * Number the day, week, month or year holding a day, so that consecutive buckets get consecutive ids.
+     * @param day: Days since 1970-01-01.
+     * @param granularity: The size of the buckets.
+     * @return: The day itself, Monday-based weeks since 1970-01-05, months since year 0, or the year.
      */
 
-    const std::string date_a_cpy {a.get_date()};
-    const std::string date_b_cpy {b.get_date()};
+    switch (granularity) {
+        case TimeGranularity::Day:
+            return day;
+        case TimeGranularity::Week:
+            return (civil_date::week_start(day, civil_date::monday) - first_monday) / 7;
+        case TimeGranularity::Month: {
+            const YearMonthDay date {civil_date::civil_from_days(day)};
+            return date.year * 12 + static_cast<int>(date.month) - 1;
+        }
+        case TimeGranularity::Year:
+            return civil_date::civil_from_days(day).year;
+    }
+    return day;
+}
 
-    int date_a {parse_date(date_a_cpy)};
-    int date_b {parse_date(date_b_cpy)};
+int GraphingCalculations::bucket_start_day(const int bucket, const TimeGranularity granularity) {
+    /*
+     * Find the first day of a bucket. Inverse of bucket_id.
+     * @param bucket: A bucket id from bucket_id.
+     * @param granularity: The size of the buckets.
+     * @return: Days since 1970-01-01 of the first day in the bucket.
+     */
 
-    return date_a < date_b;
+    switch (granularity) {
+        case TimeGranularity::Day:
+            return bucket;
+        case TimeGranularity::Week:
+            return bucket * 7 + first_monday;
+        case TimeGranularity::Month:
+            return civil_date::days_from_civil(bucket / 12, static_cast<unsigned>(bucket % 12) + 1, 1);
+        case TimeGranularity::Year:
+            return civil_date::days_from_civil(bucket, 1, 1);
+    }
+    return bucket;
 }
 
-int GraphingCalculations::parse_date(const std::string &date) {
+BucketRange GraphingCalculations::bucket_range(const std::vector<DrinkFacts>& all_drinks,
+                                               const TimeGranularity granularity) {
     /*
-     * Convert date string to integer date.
-     * @param date: A date in the format YYYYMMDD
-     * @return: an integer in UNIX epoch time
+     * Find the buckets spanning the drinks, so a series can be allocated once with a zero in every empty bucket.
+     * @param all_drinks: Facts for the drinks to graph, in any order.
+     * @param granularity: Whether to bucket by day, week, month or year.
+     * @return: The range. It has no buckets if there are no drinks.
      */
 
-    std::tm t {};
-    std::stringstream date_str;
-    date_str.str(date);
-    std::stringstream new_date;
+    BucketRange range;
+    range.granularity = granularity;
+    if (all_drinks.empty()) {
+        return range;
+    }
 
-    date_str >> std::get_time(&t, "%Y%m%d");
-    std::put_time(&t, "%c");
-    auto timet = (int)std::mktime(&t);
+    int first_day {all_drinks.front().day};
+    int last_day {all_drinks.front().day};
+    for (const DrinkFacts& drink : all_drinks) {
+        first_day = std::min(first_day, drink.day);
+        last_day = std::max(last_day, drink.day);
+    }
 
-    return timet;
+    range.first_bucket = bucket_id(first_day, granularity);
+    range.count = static_cast<std::size_t>(bucket_id(last_day, granularity) - range.first_bucket + 1);
+    return range;
 }
 
-std::string GraphingCalculations::week_number(const int date) {
+TimeSeries GraphingCalculations::bucket_std_drinks(const std::vector<DrinkFacts>& all_drinks,
+                                                   const double std_drink_size, const TimeGranularity granularity) {
     /*
-     * Get the week number for a date
-     * @param date: An integer of date, e.g. 20210405
-     * @return: year and week number, e.g. 2021-05
+     * Sum standard drinks per bucket into a flat array indexed by bucket id, from the first drink's bucket to the
+     * last one's.
+     * @param all_drinks: Facts for the drinks to graph, in any order.
+     * @param std_drink_size: Size of a standard drink, in oz. alcohol.
+     * @param granularity: Whether to sum by day, week, month or year.
+     * @return: The series. It has no buckets if there are no drinks.
      */
 
-    constexpr int days_per_week {7};
-    struct tm tm{};
-    strptime(std::to_string(date).c_str(), "%Y%m%d", &tm);
+    const BucketRange range {bucket_range(all_drinks, granularity)};
 
-    const int wday {tm.tm_wday};
-    const int delta {wday ? wday - 1 : days_per_week - 1};
-
-    const int week_num {(tm.tm_yday + days_per_week - delta) / days_per_week};
+    TimeSeries series;
+    series.granularity = granularity;
+    series.first_bucket = range.first_bucket;
+    series.std_drinks.assign(range.count, 0.0);
+    for (const DrinkFacts& drink : all_drinks) {
+        series.std_drinks[static_cast<std::size_t>(bucket_id(drink.day, granularity) - series.first_bucket)] +=
+                drink.standard_drinks(std_drink_size);
+    }
 
-    return std::to_string(date).substr(0, 4) + '-' + std::to_string(week_num);
+    return series;
 }
 
-int GraphingCalculations::date_from_week_num(const std::string& week_num) {
+TimeSeries GraphingCalculations::bucket_daily_totals(const std::vector<DailyTotal>& totals, const double std_drink_size,
+                                                     const TimeGranularity granularity) {
     /*
-     * Calculates the date from a week number.
-     * @param week_num: theweek number to calculate the date for.
-     * @return an integer denoting date, in YYYYMMDD format.
+     * Sum standard drinks per bucket from the daily_totals table, which holds one row per day and alcohol type, so
+     * this costs the number of days drunk on rather than the number of drinks.
+     * @param totals: Rows from Database::daily_totals, ordered by day.
+     * @param std_drink_size: Size of a standard drink, in oz. alcohol.
+     * @param granularity: Whether to sum by day, week, month or year.
+     * @return: The series. It has no buckets if there are no totals.
      */
 
-    struct tm tm{};
-    const std::string week_num_tmp {week_num + "-1"};
-    strptime(week_num_tmp.c_str(), "%Y-%W-%w", &tm);
-
-    std::string year {std::to_string(tm.tm_year +1900)};
-    std::string month {std::to_string(tm.tm_mon + 1)};
-    std::string day {std::to_string(tm.tm_mday)};
-
-    month = (month.length() == 1) ? '0' + month : month; // Zero pad if single digit month
-    day = (day.length() == 1) ? '0' + day : day;  // Zero pad if single digit day
+    TimeSeries series;
+    series.granularity = granularity;
+    if (totals.empty()) {
+        return series;
+    }
 
-    const std::string date_str = year + month + day;
-    int date {std::stoi(date_str)};
+    series.first_bucket = bucket_id(totals.front().day, granularity);
+    series.std_drinks.assign(static_cast<std::size_t>(bucket_id(totals.back().day, granularity) -
+                                                      series.first_bucket + 1), 0.0);
+    for (const DailyTotal& total : totals) {
+        series.std_drinks[static_cast<std::size_t>(bucket_id(total.day, granularity) - series.first_bucket)] +=
+                total.alcohol_volume / std_drink_size;
+    }
 
-    return date;
-}
\ No newline at end of file
+    return series;
+}
@@ -9,16 +9,49 @@
 #include <string>
 #include <map>
 #include "drink.h"
+#include "drink_facts.h"
+
+struct DailyTotal;
+
+enum class TimeGranularity {
+    Day, Week, Month, Year  // In the order of the graph window's "Group by" box
+};
+
+struct BucketRange {
+    /*
+     * The contiguous buckets from the first drink's to the last drink's. Bucket first_bucket + i goes in slot i.
+     */
+
+    TimeGranularity granularity {TimeGranularity::Week};
+    int first_bucket {0};
+    std::size_t count {0};
+};
+
+struct TimeSeries {
+    /*
+     * Standard drinks summed per day, week, month or year. Buckets are contiguous from first_bucket, so a bucket with
+     * no drinks holds zero.
+     */
+
+    TimeGranularity granularity {TimeGranularity::Week};
+    int first_bucket {0};
+    std::vector<double> std_drinks {};
+};
 
 class GraphingCalculations {
 public:
     static std::vector<double> get_beer_ibus(const std::vector<Drink>& all_drinks);
     static std::vector<double> get_drink_abvs(const std::vector<Drink>& all_drinks);
+    static std::vector<double> get_beer_ibus(const std::vector<DrinkFacts>& all_drinks);
+    static std::vector<double> get_drink_abvs(const std::vector<DrinkFacts>& all_drinks);
     static std::map<double, size_t> count_values_in_vect(const std::vector<double>& all_values);
-    static bool compare_by_date(const Drink &a, const Drink &b);
-    static int parse_date(const std::string &date);
-    static std::string week_number(int date);
-    static int date_from_week_num(const std::string& week_num);
+    static int bucket_id(int day, TimeGranularity granularity);
+    static int bucket_start_day(int bucket, TimeGranularity granularity);
+    static BucketRange bucket_range(const std::vector<DrinkFacts>& all_drinks, TimeGranularity granularity);
+    static TimeSeries bucket_std_drinks(const std::vector<DrinkFacts>& all_drinks, double std_drink_size,
+                                        TimeGranularity granularity);
+    static TimeSeries bucket_daily_totals(const std::vector<DailyTotal>& totals, double std_drink_size,
+                                          TimeGranularity granularity);
 };
 
 
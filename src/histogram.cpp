@@ -0,0 +1,224 @@
+#include "histogram.h"
+#include "graphing_calculations.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+
+Histogram Histograms::fixed_width(const std::vector<double>& values, const double bin_width, const double minimum,
+                                  const double maximum) {
+    /*
+     * Count values into bins of equal width, in one pass.
+     * @param values: The values to count, in any order.
+     * @param bin_width: Width of each bin. Must be positive.
+     * @param minimum: Lower edge of the first bin.
+     * @param maximum: Upper edge of the last bin, which is rounded up to a whole number of bins. Values equal to it
+     * fall in the last bin. If that would take more than max_bins bins, the bins stop there instead.
+     * @return: The histogram. It has no bins if maximum is below minimum or bin_width isn't positive.
+     */
+
+    Histogram histogram;
+    if (!(bin_width > 0) || maximum < minimum) {
+        histogram.out_of_range = values.size();
+        return histogram;
+    }
+
+    // Capped as a double, since a huge range overflows std::size_t
+    const double span_bins {std::max(1.0, std::ceil((maximum - minimum) / bin_width))};
+    const auto bin_count {static_cast<std::size_t>(std::min(static_cast<double>(max_bins), span_bins))};
+    histogram.bins.resize(bin_count);
+    for (std::size_t i = 0; i < bin_count; i++) {
+        histogram.bins[i].lower = minimum + static_cast<double>(i) * bin_width;
+        histogram.bins[i].upper = minimum + static_cast<double>(i + 1) * bin_width;
+    }
+    const double upper_edge {histogram.bins.back().upper};
+
+    for (const double value : values) {
+        if (!(value >= minimum && value <= upper_edge)) {  // Also catches NaN
+            histogram.out_of_range++;
+            continue;
+        }
+        // Rounding can put the upper edge, or a value just below it, one past the last bin
+        const auto bin {std::min(static_cast<std::size_t>((value - minimum) / bin_width), bin_count - 1)};
+        histogram.bins[bin].count++;
+        histogram.total++;
+    }
+
+    return histogram;
+}
+
+Histogram Histograms::fixed_width(const std::vector<double>& values, const double bin_width,
+                                  const std::pair<double, double>& limits) {
+    /*
+     * Count values into bins of equal width, over a range snapped to multiples of the width that holds all of them
+     * within limits. The largest value gets a bin to itself if it lands on an edge, so ratings of 10 aren't lumped
+     * with 9s.
+     * @param values: The values to count, in any order.
+     * @param bin_width: Width of each bin. Must be positive.
+     * @param limits: Lowest and highest values to bin, e.g. from plausible_range. Values outside them, such as a typo
+     * of 5000 oz., are only counted in out_of_range, so they can't stretch the range.
+     * @return: The histogram. It has no bins if no values are within limits.
+     */
+
+    const auto [lowest, highest] {limits};
+    double smallest {std::numeric_limits<double>::infinity()};
+    double largest {-std::numeric_limits<double>::infinity()};
+    for (const double value : values) {
+        if (value >= lowest && value <= highest) {  // Also skips NaN
+            smallest = std::min(smallest, value);
+            largest = std::max(largest, value);
+        }
+    }
+    if (smallest > largest || !(bin_width > 0)) {
+        return fixed_width(values, 1.0, 0.0, -1.0);
+    }
+
+    const double minimum {std::floor(smallest / bin_width) * bin_width};
+    const double maximum {(std::floor(largest / bin_width) + 1) * bin_width};
+    return fixed_width(values, bin_width, minimum, maximum);
+}
+
+Histogram Histograms::fixed_width(const std::vector<double>& values, const double bin_width) {
+    /*
+     * Count values into bins of equal width, over a range snapped to multiples of the width that holds all of them.
+     * @param values: The values to count, in any order.
+     * @param bin_width: Width of each bin. Must be positive.
+     * @return: The histogram. It has no bins if there are no values, and at most max_bins.
+     */
+
+    return fixed_width(values, bin_width, {-std::numeric_limits<double>::infinity(),
+                                           std::numeric_limits<double>::infinity()});
+}
+
+Histogram Histograms::quantiles(std::vector<double> values, const int bin_count) {
+    /*
+     * Count values into bins holding roughly equal numbers of values. Ties are never split, so bins whose edges
+     * coincide are merged and there may be fewer than bin_count bins.
+     * @param values: The values to count, in any order.
+     * @param bin_count: Number of bins to aim for, e.g. 10 for deciles.
+     * @return: The histogram. It has no bins if there are no values.
+     */
+
+    Histogram histogram;
+    values.erase(std::remove_if(values.begin(), values.end(), [](const double value) { return std::isnan(value); }),
+                 values.end());
+    if (values.empty() || bin_count < 1) {
+        return histogram;
+    }
+    std::sort(values.begin(), values.end());
+
+    // Edges at each quantile, with duplicates from ties removed
+    std::vector<double> edges;
+    edges.reserve(static_cast<std::size_t>(bin_count) + 1);
+    for (int i = 0; i < bin_count; i++) {
+        const double edge {values[values.size() * static_cast<std::size_t>(i) / static_cast<std::size_t>(bin_count)]};
+        if (edges.empty() || edge > edges.back()) {
+            edges.push_back(edge);
+        }
+    }
+    if (edges.size() < 2 || values.back() > edges.back()) {
+        edges.push_back(values.back());
+    }
+    if (edges.size() < 2) {  // Every value is the same
+        edges.push_back(edges.back());
+    }
+
+    histogram.bins.resize(edges.size() - 1);
+    for (std::size_t i = 0; i + 1 < edges.size(); i++) {
+        histogram.bins[i].lower = edges[i];
+        histogram.bins[i].upper = edges[i + 1];
+    }
+
+    // Values are sorted, so walk the bins alongside them
+    std::size_t bin {0};
+    for (const double value : values) {
+        while (bin + 1 < histogram.bins.size() && value >= histogram.bins[bin].upper) {
+            bin++;
+        }
+        histogram.bins[bin].count++;
+    }
+    histogram.total = values.size();
+
+    return histogram;
+}
+
+std::vector<double> Histograms::metric_values(const std::vector<DrinkFacts>& all_drinks,
+                                              const HistogramMetric metric, const double std_drink_size) {
+    /*
+     * Pick the values to draw a distribution of.
+     * @param all_drinks: Facts for all drinks.
+     * @param metric: IBU (beers with an IBU), ABV, size in oz., rating (rated drinks), or standard drinks per day on
+     * days with any drinks.
+     * @param std_drink_size: Size of a standard drink, in oz. alcohol. Only used for standard drinks per day.
+     * @return: The values, one per drink or drinking day.
+     */
+
+    std::vector<double> values;
+    switch (metric) {
+        case HistogramMetric::Ibu:
+            return GraphingCalculations::get_beer_ibus(all_drinks);
+        case HistogramMetric::Abv:
+            return GraphingCalculations::get_drink_abvs(all_drinks);
+        case HistogramMetric::Size:
+            values.reserve(all_drinks.size());
+            for (const DrinkFacts& drink : all_drinks) {
+                values.push_back(drink.size);
+            }
+            break;
+        case HistogramMetric::Rating:
+            for (const DrinkFacts& drink : all_drinks) {
+                if (drink.rating >= 0) {
+                    values.push_back(drink.rating);
+                }
+            }
+            break;
+        case HistogramMetric::StdDrinksPerDay: {
+            const TimeSeries days {GraphingCalculations::bucket_std_drinks(all_drinks, std_drink_size,
+                                                                           TimeGranularity::Day)};
+            std::copy_if(days.std_drinks.begin(), days.std_drinks.end(), std::back_inserter(values),
+                         [](const double std_drinks) { return std_drinks > 0; });
+            break;
+        }
+    }
+
+    return values;
+}
+
+double Histograms::default_bin_width(const HistogramMetric metric) {
+    /*
+     * Bin width for a metric's fixed-width histogram, in the metric's own units.
+     */
+
+    switch (metric) {
+        case HistogramMetric::Ibu:
+            return 5.0;
+        case HistogramMetric::Abv:
+        case HistogramMetric::StdDrinksPerDay:
+            return 0.5;
+        case HistogramMetric::Size:
+        case HistogramMetric::Rating:
+            return 1.0;
+    }
+    return 1.0;
+}
+
+std::pair<double, double> Histograms::plausible_range(const HistogramMetric metric) {
+    /*
+     * Range of values a metric can sensibly take, in the metric's own units. Anything outside is a typo or a unit
+     * mix-up, and is left out of fixed-width bins.
+     */
+
+    switch (metric) {
+        case HistogramMetric::Ibu:
+            return {0.0, 150.0};
+        case HistogramMetric::Abv:
+            return {0.0, 100.0};
+        case HistogramMetric::Size:
+            return {0.0, 128.0};  // A gallon
+        case HistogramMetric::Rating:
+            return {0.0, 10.0};
+        case HistogramMetric::StdDrinksPerDay:
+            return {0.0, 50.0};
+    }
+    return {0.0, 0.0};
+}
@@ -0,0 +1,45 @@
+#ifndef BUZZBOT_HISTOGRAM_H
+#define BUZZBOT_HISTOGRAM_H
+
+#include "drink_facts.h"
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+enum class HistogramMetric {
+    Ibu, Abv, Size, Rating, StdDrinksPerDay  // In the order of the graph window's "Distribution" box
+};
+
+struct HistogramBin {
+    double lower {0.0};
+    double upper {0.0};  // Exclusive, except in the last bin
+    std::size_t count {0};
+};
+
+struct Histogram {
+    /*
+     * Counts of values per bin. Bins are sorted and contiguous. Values outside them are only counted in out_of_range.
+     */
+
+    std::vector<HistogramBin> bins {};
+    std::size_t total {0};  // Values that fell in a bin
+    std::size_t out_of_range {0};
+};
+
+class Histograms {
+public:
+    static constexpr std::size_t max_bins {1000};  // Fixed-width histograms stop here, whatever their range
+
+    static Histogram fixed_width(const std::vector<double>& values, double bin_width, double minimum, double maximum);
+    static Histogram fixed_width(const std::vector<double>& values, double bin_width,
+                                 const std::pair<double, double>& limits);
+    static Histogram fixed_width(const std::vector<double>& values, double bin_width);
+    static Histogram quantiles(std::vector<double> values, int bin_count);
+    static std::vector<double> metric_values(const std::vector<DrinkFacts>& all_drinks, HistogramMetric metric,
+                                             double std_drink_size);
+    static double default_bin_width(HistogramMetric metric);
+    static std::pair<double, double> plausible_range(HistogramMetric metric);
+};
+
+
+#endif //BUZZBOT_HISTOGRAM_H
@@ -0,0 +1,308 @@
+#include "importers.h"
+#include "calculate.h"
+#include "civil_date.h"
+#include "drink_writer.h"
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    constexpr std::size_t chunk_size {1 << 20};  // Read the file 1 MiB at a time
+    constexpr std::size_t column_count {14};
+    constexpr std::size_t max_reported_errors {20};
+
+    class CsvReader {
+        /*
+         * Streams RFC 4180 records out of a file without loading it into memory. Quoted fields may contain commas,
+         * line breaks and doubled quotes. A lone quote inside a quoted field that isn't followed by a delimiter is
+         * kept as a literal character, which is how older BuzzBot exports wrote quotes in notes.
+         */
+
+    public:
+        explicit CsvReader(const std::string &path) : input(path, std::ios::binary) {
+            buffer.resize(chunk_size);
+        }
+
+        [[nodiscard]] bool is_open() const {
+            return input.is_open();
+        }
+
+        [[nodiscard]] std::size_t line_number() const {
+            return record_line;
+        }
+
+        bool next_record(std::vector<std::string> &fields) {
+            /*
+             * Read the next record.
+             * @param fields: Receives the record's fields. Existing strings are reused to avoid reallocating.
+             * @return: False at end of file.
+             */
+
+            std::size_t field_count {0};
+            bool in_quotes {false};
+            bool field_started {false};
+            record_line = current_line;
+
+            if (peek() == end_of_file) {
+                return false;
+            }
+
+            const auto next_field = [&]() -> std::string & {
+                if (fields.size() <= field_count) {
+                    fields.emplace_back();
+                }
+                std::string &field {fields[field_count]};
+                if (!field_started) {
+                    field.clear();
+                    field_started = true;
+                }
+                return field;
+            };
+
+            while (true) {
+                const int c {get()};
+                if (c == end_of_file) {
+                    break;
+                }
+                if (in_quotes) {
+                    if (c == '"') {
+                        const int following {peek()};
+                        if (following == '"') {  // Escaped quote
+                            get();
+                            next_field().push_back('"');
+                        } else if (following == ',' || following == '\n' || following == '\r' || following == end_of_file) {
+                            in_quotes = false;
+                        } else {
+                            next_field().push_back('"');
+                        }
+                    } else {
+                        if (c == '\n') {
+                            current_line++;
+                        }
+                        next_field().push_back(static_cast<char>(c));
+                    }
+                } else if (c == '"') {
+                    next_field();
+                    in_quotes = true;
+                } else if (c == ',') {
+                    next_field();
+                    field_count++;
+                    field_started = false;
+                } else if (c == '\r' || c == '\n') {
+                    if (c == '\r' && peek() == '\n') {
+                        get();
+                    }
+                    current_line++;
+                    break;
+                } else {
+                    next_field().push_back(static_cast<char>(c));
+                }
+            }
+
+            next_field();
+            fields.resize(field_count + 1);
+            return true;
+        }
+
+    private:
+        static constexpr int end_of_file {-1};
+
+        std::ifstream input;
+        std::vector<char> buffer;
+        std::size_t position {0};
+        std::size_t filled {0};
+        std::size_t current_line {1};
+        std::size_t record_line {1};
+
+        bool refill() {
+            input.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            filled = static_cast<std::size_t>(input.gcount());
+            position = 0;
+            return filled > 0;
+        }
+
+        int peek() {
+            if (position == filled && !refill()) {
+                return end_of_file;
+            }
+            return static_cast<unsigned char>(buffer[position]);
+        }
+
+        int get() {
+            const int c {peek()};
+            if (c != end_of_file) {
+                position++;
+            }
+            return c;
+        }
+    };
+
+    bool parse_double(const std::string &text, double &value) {
+        char *end {nullptr};
+        errno = 0;
+        value = std::strtod(text.c_str(), &end);
+        return !text.empty() && end == text.c_str() + text.size() && errno == 0;
+    }
+
+    bool parse_int(const std::string &text, int &value) {
+        char *end {nullptr};
+        errno = 0;
+        const long parsed {std::strtol(text.c_str(), &end, 10)};
+        value = static_cast<int>(parsed);
+        return !text.empty() && end == text.c_str() + text.size() && errno == 0;
+    }
+
+    class BulkWriteGuard {
+        /*
+         * Sets the database up for a bulk write and puts it back however the write ends. The daily_totals triggers
+         * are dropped, so the totals are refilled once instead of per row, and the synchronous pragma is restored to
+         * what it was before the writer turned it off.
+         */
+
+    public:
+        explicit BulkWriteGuard(Storage &in_storage) : storage(in_storage),
+                                                       previous_synchronous(in_storage.pragma.synchronous()) {
+            Database::drop_daily_totals_triggers(storage);
+        }
+
+        BulkWriteGuard(const BulkWriteGuard &) = delete;
+        BulkWriteGuard &operator=(const BulkWriteGuard &) = delete;
+
+        ~BulkWriteGuard() {
+            try {
+                Database::create_daily_totals(storage);
+                storage.pragma.synchronous(previous_synchronous);
+            } catch (const std::exception &e) {
+                // The next startup's migration recreates the triggers
+                std::cerr << "Could not restore the database after an import: " << e.what() << std::endl;
+            }
+        }
+
+    private:
+        Storage &storage;
+        const int previous_synchronous;
+    };
+}
+
+ImportResult importers::from_csv(const std::string &path, Storage &storage, const std::size_t batch_size) {
+    /*
+     * Import drinks from a CSV file with the columns written by exporters::to_csv. The file is parsed in chunks
+     * and rows are inserted through one prepared statement in large transactions. IDs in the file are ignored;
+     * imported drinks get new primary keys. If a write fails, the batch it was in is rolled back and the import
+     * stops; batches committed before it are kept, and are the only rows counted as imported.
+     * @param path: Path to the CSV file.
+     * @param storage: An open storage. Should be the long-lived repository connection.
+     * @param batch_size: Rows per transaction.
+     * @return: Counts of imported and skipped rows, plus the first few errors.
+     */
+
+    ImportResult result;
+    CsvReader reader(path);
+
+    if (!reader.is_open()) {
+        result.errors.push_back("Could not open " + path);
+        return result;
+    }
+
+    std::vector<std::string> fields;
+    if (!reader.next_record(fields) || fields.size() != column_count || fields.at(0) != "Date") {
+        result.errors.push_back("Not a BuzzBot export: unexpected header in " + path);
+        return result;
+    }
+    // Sizes are stored in oz. Convert them if the export was written in metric units.
+    const bool metric {fields.at(8) == "Size (ml)"};
+
+    // Maintaining daily_totals per row would cost more than the inserts. Refill it once at the end instead.
+    const BulkWriteGuard guard(storage);
+    DrinkWriter writer(storage, batch_size, Durability::Off);
+    Drink drink;
+    std::string error;
+    std::size_t uncommitted {0};
+
+    try {
+        while (reader.next_record(fields)) {
+            if (fields.size() == 1 && fields.at(0).empty()) {  // Blank line
+                continue;
+            }
+
+            if (parse_row(fields, metric, drink, error)) {
+                writer.insert(drink);
+                uncommitted++;
+                if (writer.pending() == 0) {  // The insert filled the batch, which was committed
+                    result.imported += uncommitted;
+                    uncommitted = 0;
+                }
+            } else {
+                result.skipped++;
+                if (result.errors.size() < max_reported_errors) {
+                    result.errors.push_back("Line " + std::to_string(reader.line_number()) + ": " + error);
+                }
+            }
+        }
+        writer.flush();
+        result.imported += uncommitted;
+    } catch (const std::exception &e) {
+        // The writer rolled back the failed batch; the batches before it stay
+        result.errors.push_back("Import stopped at line " + std::to_string(reader.line_number()) + ": " + e.what());
+    }
+
+    std::cout << "Imported " << result.imported << " drinks from " << path << ", skipped " << result.skipped
+              << std::endl;
+
+    return result;
+}
+
+bool importers::parse_row(const std::vector<std::string> &fields, const bool metric, Drink &drink,
+                          std::string &error) {
+    /*
+     * Convert one CSV record into a drink.
+     * @param fields: The record's fields, in exporters::to_csv column order.
+     * @param metric: True if the size column is in ml.
+     * @param drink: Receives the parsed drink.
+     * @param error: Receives a description of the problem if the row is invalid.
+     * @return: True if the row is valid.
+     */
+
+    if (fields.size() != column_count) {
+        error = "expected " + std::to_string(column_count) + " columns, found " + std::to_string(fields.size());
+        return false;
+    }
+
+    // A real YYYY-MM-DD date comes back unchanged. Anything else, e.g. 2021-13-45, would be stored on day 0.
+    const std::string &date {fields[0]};
+    if (civil_date::to_iso(civil_date::from_iso(date)) != date) {
+        error = "invalid date '" + date + "'";
+        return false;
+    }
+
+    double abv;
+    double ibu {-1.0};
+    double size;
+    int vintage {-999};
+    int rating;
+    if (!parse_double(fields[6], abv) || !parse_double(fields[8], size) || !parse_int(fields[9], rating) ||
+            (!fields[7].empty() && !parse_double(fields[7], ibu)) ||
+            (!fields[5].empty() && !parse_int(fields[5], vintage))) {
+        error = "invalid number";
+        return false;
+    }
+
+    drink.set_id(-1);
+    drink.set_date(date);
+    drink.set_name(fields[1]);
+    drink.set_type(fields[2]);
+    drink.set_subtype(fields[3]);
+    drink.set_producer(fields[4]);
+    drink.set_vintage(vintage);
+    drink.set_abv(abv);
+    drink.set_ibu(ibu);
+    drink.set_size(metric ? Calculate::ml_to_oz(size) : size);
+    drink.set_rating(rating);
+    drink.set_notes(fields[10]);
+    drink.set_alcohol_type(fields[11]);
+    drink.set_timestamp(fields[12]);
+    drink.set_sort_order(0);
+
+    return true;
+}
@@ -0,0 +1,24 @@
+#ifndef BUZZBOT_IMPORTERS_H
+#define BUZZBOT_IMPORTERS_H
+
+#include "database.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct ImportResult {
+    std::size_t imported {0};
+    std::size_t skipped {0};
+    std::vector<std::string> errors;  // First few problems, with CSV line numbers
+};
+
+class importers {
+public:
+    static ImportResult from_csv(const std::string &path, Storage &storage, std::size_t batch_size = 50000);
+
+private:
+    static bool parse_row(const std::vector<std::string> &fields, bool metric, Drink &drink, std::string &error);
+};
+
+
+#endif //BUZZBOT_IMPORTERS_H
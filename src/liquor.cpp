@@ -8,7 +8,17 @@
 
 void MainWindow::update_liquor_fields() {
     /*
-     * Read rows in the DB and populate the distiller, type, subtype, and name dropdowns with unique values.
+     * Read the liquors in the DB and populate the liquor dropdowns from them.
+     */
+
+    update_liquor_fields(Database::filter("Alcohol Type", "Liquor", storage));
+}
+
+void MainWindow::update_liquor_fields(std::vector<Drink> all_liquor) {
+    /*
+     * Populate the distiller, type, subtype, and name dropdowns with unique values.
+     * @param all_liquor: Liquor drinks with at least their names, types, subtypes and producers. Passed in so one
+     * read can serve all three tabs.
      */
 
     std::set<QString> distilleries;
@@ -17,8 +27,6 @@ void MainWindow::update_liquor_fields() {
     std::vector<std::string> names_tmp;
     std::set<std::string> names;
 
-    std::vector<Drink> all_liquor = Database::filter("Alcohol Type", "Liquor", storage);
-
     // Block signals to avoid crashing
     QSignalBlocker brewery_signal_blocker(ui->liquorDistillerInput);
     QSignalBlocker type_signal_blocker(ui->liquorTypeInput);
@@ -0,0 +1,123 @@
+#include "lod_pyramid.h"
+#include <algorithm>
+
+LodPyramid::LodPyramid(const std::vector<double> &keys, const std::vector<double> &values) {
+    /*
+     * Build every level of the pyramid.
+     * @param keys: Keys of the series, sorted ascending.
+     * @param values: One value per key.
+     */
+
+    const std::size_t point_count {std::min(keys.size(), values.size())};
+    if (point_count == 0) {
+        return;
+    }
+
+    std::vector<LodPoint> base(point_count);
+    for (std::size_t i = 0; i < point_count; i++) {
+        base[i] = LodPoint{keys[i], keys[i], values[i], values[i], values[i], 1};
+    }
+    pyramid.push_back(std::move(base));
+
+    // Halve until one point covers the whole series
+    while (pyramid.back().size() > 1) {
+        const std::vector<LodPoint> &below {pyramid.back()};
+        std::vector<LodPoint> above((below.size() + 1) / 2);
+        for (std::size_t i = 0; i < above.size(); i++) {
+            const LodPoint &left {below[2 * i]};
+            if (2 * i + 1 == below.size()) {  // Odd point out carries up unmerged
+                above[i] = left;
+                continue;
+            }
+            const LodPoint &right {below[2 * i + 1]};
+            above[i] = LodPoint{left.key, right.last_key, std::min(left.min, right.min), std::max(left.max, right.max),
+                                left.sum + right.sum, left.count + right.count};
+        }
+        pyramid.push_back(std::move(above));
+    }
+}
+
+std::size_t LodPyramid::levels() const {
+    /*
+     * Number of levels, including the series itself. Zero if the series is empty.
+     */
+
+    return pyramid.size();
+}
+
+const std::vector<LodPoint> &LodPyramid::level(const std::size_t level_index) const {
+    /*
+     * The points of one level. Level 0 is the series itself.
+     */
+
+    return pyramid.at(level_index);
+}
+
+std::size_t LodPyramid::level_for(const double first_key, const double last_key, const int pixel_width) const {
+    /*
+     * Pick the finest level with no more than one point per pixel in a range. Each point is drawn as its min and max,
+     * so that is two plotted values per pixel column.
+     * @param first_key: Start of the visible range.
+     * @param last_key: End of the visible range.
+     * @param pixel_width: Width of the plot area, in pixels.
+     * @return: The level index.
+     */
+
+    if (pyramid.empty()) {
+        return 0;
+    }
+
+    const std::vector<LodPoint> &base {pyramid.front()};
+    std::size_t points_in_range {end_index(base, last_key) - first_index(base, first_key)};
+    const auto budget {static_cast<std::size_t>(std::max(pixel_width, 1))};
+
+    std::size_t level_index {0};
+    while (points_in_range > budget && level_index + 1 < pyramid.size()) {
+        points_in_range = (points_in_range + 1) / 2;
+        level_index++;
+    }
+    return level_index;
+}
+
+std::vector<LodPoint> LodPyramid::visible(const double first_key, const double last_key, const int pixel_width) const {
+    /*
+     * Points to draw for a range, from the level picked by level_for. One point either side of the range is included
+     * so lines run off the plot edges instead of stopping short.
+     * @param first_key: Start of the visible range.
+     * @param last_key: End of the visible range.
+     * @param pixel_width: Width of the plot area, in pixels.
+     * @return: The points, sorted by key.
+     */
+
+    if (pyramid.empty() || last_key < first_key) {
+        return {};
+    }
+
+    const std::vector<LodPoint> &points {pyramid[level_for(first_key, last_key, pixel_width)]};
+    const std::size_t first {first_index(points, first_key)};
+    const std::size_t end {end_index(points, last_key)};
+    return {points.begin() + static_cast<std::ptrdiff_t>(first > 0 ? first - 1 : first),
+            points.begin() + static_cast<std::ptrdiff_t>(std::min(end + 1, points.size()))};
+}
+
+std::size_t LodPyramid::first_index(const std::vector<LodPoint> &points, const double key) {
+    /*
+     * Index of the first point that ends at or after key.
+     */
+
+    return static_cast<std::size_t>(std::lower_bound(points.begin(), points.end(), key,
+                                                     [](const LodPoint &point, const double value) {
+                                                         return point.last_key < value;
+                                                     }) - points.begin());
+}
+
+std::size_t LodPyramid::end_index(const std::vector<LodPoint> &points, const double key) {
+    /*
+     * Index one past the last point that starts at or before key.
+     */
+
+    return static_cast<std::size_t>(std::upper_bound(points.begin(), points.end(), key,
+                                                     [](const double value, const LodPoint &point) {
+                                                         return value < point.key;
+                                                     }) - points.begin());
+}
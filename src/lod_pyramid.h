@@ -0,0 +1,41 @@
+#ifndef BUZZBOT_LOD_PYRAMID_H
+#define BUZZBOT_LOD_PYRAMID_H
+
+#include <cstddef>
+#include <vector>
+
+struct LodPoint {
+    double key {0.0};  // Key of the first point covered
+    double last_key {0.0};  // Key of the last point covered
+    double min {0.0};
+    double max {0.0};
+    double sum {0.0};
+    std::size_t count {0};  // Points covered
+};
+
+class LodPyramid {
+    /*
+     * Level-of-detail copies of a time series, for plotting long series without drawing thousands of points per
+     * pixel column. Level 0 is the series itself; each level above it merges pairs of neighbouring points from the
+     * level below, keeping their min, max and sum. Built once in O(n); a view of any range is then picked from the
+     * coarsest level that still has about one point per pixel.
+     */
+
+public:
+    LodPyramid() = default;
+    LodPyramid(const std::vector<double> &keys, const std::vector<double> &values);
+
+    [[nodiscard]] std::size_t levels() const;
+    [[nodiscard]] const std::vector<LodPoint> &level(std::size_t level_index) const;
+    [[nodiscard]] std::size_t level_for(double first_key, double last_key, int pixel_width) const;
+    [[nodiscard]] std::vector<LodPoint> visible(double first_key, double last_key, int pixel_width) const;
+
+private:
+    std::vector<std::vector<LodPoint>> pyramid;
+
+    [[nodiscard]] static std::size_t first_index(const std::vector<LodPoint> &points, double key);
+    [[nodiscard]] static std::size_t end_index(const std::vector<LodPoint> &points, double key);
+};
+
+
+#endif //BUZZBOT_LOD_PYRAMID_H
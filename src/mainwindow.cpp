@@ -5,9 +5,13 @@
 #include "standard_drink_calculator.h"
 #include "confirm_dialog.h"
 #include "exporters.h"
+#include "importers.h"
 #include "calculate.h"
 #include "graphing.h"
 #include "utilities.h"
+#include "settings_snapshot.h"
+#include "drink_query.h"
+#include "civil_date.h"
 #include <iomanip>
 #include <filesystem>
 #include <iostream>
@@ -16,8 +20,8 @@
 #include <QMessageBox>
 #include <QStandardPaths>
 #include <QFileDialog>
+#include <QHeaderView>
 #include <QTimer>
-#include <chrono>
 
 #ifdef __APPLE__
     #include <CoreFoundation/CFBundle.h>
@@ -33,6 +37,16 @@ MainWindow::MainWindow(QWidget *parent)
 
     ui->setupUi(this);
 
+    // The table view shows the drink model through a proxy, which sorts without touching the model's rows
+    drink_table_model = new DrinkTableModel(this);
+    drink_table_proxy = new QSortFilterProxyModel(this);
+    drink_table_proxy->setSourceModel(drink_table_model);
+    drink_table_proxy->setSortRole(DrinkTableModel::sort_role);
+    ui->drinkLogTable->setModel(drink_table_proxy);
+    // Rows are paged in newest first, so sorting any other way needs the rest of the log read
+    connect(ui->drinkLogTable->horizontalHeader(), &QHeaderView::sortIndicatorChanged, drink_table_model,
+            &DrinkTableModel::sort_changed);
+
     // Select entire row vs just a cell
     ui->drinkLogTable->setSelectionBehavior(QAbstractItemView::SelectRows);
 
@@ -64,15 +78,11 @@ MainWindow::MainWindow(QWidget *parent)
     ui->tabWidget->setCurrentIndex(0);
 
     configure_calendar();
-    Database::write_db_to_disk(storage);
     update_stat_panel();
 
     // Set up button and input states
     set_input_states();
 
-    // Enable this on release
-    ui->drinkLogTable->setRowCount(0);
-
     // Disable cell editing
     ui->drinkLogTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
 
@@ -113,22 +123,26 @@ void MainWindow::add_menubar_items() {
     QMenu * app_menu = menuBar()->addMenu("App Menu");
     auto * preferences_action = new QAction("Preferences", this);
     auto * about_action = new QAction("About", this);
+    auto * import_action = new QAction("Import...", this);
     auto * export_action = new QAction("Export...", this);
     auto * graphs_action = new QAction("Graphs...", this);
     auto * calc_std_drinks = new QAction("Calculate Std. Drinks...", this);
     preferences_action->setMenuRole(QAction::PreferencesRole);
     about_action->setMenuRole(QAction::AboutRole);
+    import_action->setMenuRole(QAction::ApplicationSpecificRole);
     export_action->setMenuRole(QAction::ApplicationSpecificRole);
     graphs_action->setMenuRole(QAction::ApplicationSpecificRole);
     calc_std_drinks->setMenuRole(QAction::ApplicationSpecificRole);
     app_menu->addAction(preferences_action);
     app_menu->addAction(about_action);
+    app_menu->addAction(import_action);
     app_menu->addAction(export_action);
     app_menu->addAction(graphs_action);
     app_menu->addAction(calc_std_drinks);
 
     connect(preferences_action, &QAction::triggered, this, &MainWindow::open_user_settings);
     connect(about_action, &QAction::triggered, this, &MainWindow::open_about_dialog);
+    connect(import_action, &QAction::triggered, this, &MainWindow::open_import_dialog);
     connect(export_action, &QAction::triggered, this, &MainWindow::open_export_dialog);
     connect(graphs_action, &QAction::triggered, this, &MainWindow::open_graphs);
     connect(calc_std_drinks, &QAction::triggered, this, &MainWindow::open_std_drink_calculator);
@@ -197,6 +211,8 @@ void MainWindow::configure_table() {
     ui->filterCategoryInput->addItem("Subtype");
     ui->filterCategoryInput->addItem("Producer");
     ui->filterCategoryInput->addItem("Rating");
+    filter_text_model = new QStringListModel(this);
+    ui->filterTextInput->setModel(filter_text_model);
     ui->filterTextInput->setDisabled(true);
 
     // Set column widths
@@ -281,6 +297,7 @@ void MainWindow::submit_button_clicked() {
      * Create a drink from user input and write it to the database.
      */
 
+    refresh.begin_action("Submit", repository.reads());
     const QItemSelectionModel *selection_model = ui->drinkLogTable->selectionModel();
     const QModelIndexList selected_rows = selection_model->selectedRows();
 
@@ -296,14 +313,12 @@ void MainWindow::submit_button_clicked() {
         QItemSelectionModel *select = ui->drinkLogTable->selectionModel();
         (select->hasSelection()) ? update_selected_row(select, entered_drink) : add_new_row(entered_drink);
 
-        update_table();
+        // The table row was patched by the write. Everything else is refreshed once, after this slot returns.
+        unsigned stale_views {RefreshCoordinator::EntryFields | RefreshCoordinator::Stats};
         if (selected_rows.empty()) {
-            reset_fields();  // Reset fields if not updating a row
+            stale_views |= RefreshCoordinator::EntryDate;  // Reset the date if not updating a row
         }
-        update_beer_fields();
-        update_liquor_fields();
-        update_wine_fields();
-        update_stat_panel();
+        refresh.mark(stale_views);
     }
 }
 
@@ -338,6 +353,46 @@ void MainWindow::open_about_dialog() {
     about_dialog->show();
 }
 
+void MainWindow::open_import_dialog() {
+    /*
+     * Open the import dialog and load drinks from a CSV file created by the export dialog.
+     */
+
+    const QString desktop_path = QStandardPaths::standardLocations(QStandardPaths::DesktopLocation).at(0);
+
+    QString filter = "CSV Files (*.csv)";
+    const QString filepath_qstring = QFileDialog::getOpenFileName(this, "Open File", desktop_path, filter, &filter);
+    if (filepath_qstring.isEmpty()) {
+        return;
+    }
+
+    refresh.begin_action("Import", repository.reads());  // Count the import's own reads too
+    ImportResult result;
+    try {
+        result = importers::from_csv(filepath_qstring.toStdString(), storage);
+    } catch (const std::exception &error) {  // The database couldn't be set up for the import
+        result.errors.push_back(error.what());
+    }
+    repository.aggregates().invalidate();
+    repository.filters().invalidate();
+
+    QString message = QString("Imported %1 drinks.").arg(result.imported);
+    if (result.skipped > 0) {
+        message += QString(" Skipped %1 invalid rows.").arg(result.skipped);
+    }
+    for (const auto &error : result.errors) {
+        message += "\n" + QString::fromStdString(error);
+    }
+
+    if (result.imported == 0 && !result.errors.empty()) {
+        QMessageBox::critical(this, "Import Failed", message);
+        return;
+    }
+    QMessageBox::information(this, "Import Complete", message);
+
+    refresh.mark(RefreshCoordinator::Table | RefreshCoordinator::Stats | RefreshCoordinator::EntryFields);
+}
+
 void MainWindow::open_export_dialog() {
     /*
      * Open the export dialog.
@@ -349,8 +404,7 @@ void MainWindow::open_export_dialog() {
     QString filter = "CSV Files (*.csv)";
     const QString filepath_qstring = QFileDialog::getSaveFileName(this, "Save File", preferred_path, filter, &filter);
 
-    const std::vector<Drink> all_drinks = storage.get_all<Drink>();
-    exporters::to_csv(all_drinks, filepath_qstring.toStdString(), options.units);
+    exporters::to_csv(storage, filepath_qstring.toStdString(), options.units);
 }
 
 void MainWindow::open_user_settings() {
@@ -365,7 +419,15 @@ void MainWindow::open_user_settings() {
     const std::string current_db_path_setting{options.database_path};
     bool custom_db {options.custom_database};
 
-    if (user_settings.exec() == QDialog::Accepted) {  // Update settings when OK button is clicked
+    const int dialog_result {user_settings.exec()};
+    if (user_settings.get_cleared_data()) {  // Rows went away behind the repository's back
+        repository.aggregates().invalidate();
+        repository.filters().invalidate();
+        refresh.begin_action("Clear data", repository.reads());
+        refresh.mark(RefreshCoordinator::Table | RefreshCoordinator::Stats | RefreshCoordinator::EntryFields);
+    }
+
+    if (dialog_result == QDialog::Accepted) {  // Update settings when OK button is clicked
         custom_db = user_settings.get_custom_database_status();
         options.sex = user_settings.get_sex();
         options.date_calculation_method = user_settings.get_date_calculation_method();
@@ -377,7 +439,6 @@ void MainWindow::open_user_settings() {
         options.std_drink_country = user_settings.get_std_drink_country();
         options.custom_database = custom_db;
         options.database_path = user_settings.get_database_path(custom_db);
-        update_stat_panel();
     }
 
     if (options.units == "Metric") {
@@ -400,9 +461,11 @@ void MainWindow::open_user_settings() {
     }
 
     this->options.write_options();
-    update_table();
-    update_stat_panel();
-    update_types_and_producers();
+    SettingsSnapshot::publish(options);
+    drink_table_model->set_units(SettingsSnapshot::current()->std_drink_size, options.units == "Metric");
+    // Recomputed with the published standard drink size, in the same flush as any cleared data
+    refresh.begin_action("Settings", repository.reads());
+    refresh.mark(RefreshCoordinator::Stats | RefreshCoordinator::EntryFields);
     if (current_db_path_setting != options.database_path) {
         // User changed DB get_db_path settings
         const int result{Database::move_db(current_db_path_setting, options.database_path)};
@@ -619,73 +682,44 @@ void MainWindow::open_std_drink_calculator() const {
      * Open the standard drink calculator dialog box.
      */
 
-    auto * std_drink_calculator = new StandardDrinkCalc(std::stod(options.std_drink_size), options.units);
+    auto * std_drink_calculator = new StandardDrinkCalc(SettingsSnapshot::current()->std_drink_size, options.units);
     std_drink_calculator->setAttribute(Qt::WA_DeleteOnClose);  // Delete pointer on window close
     std_drink_calculator->show();
 }
 
-std::chrono::weekday MainWindow::get_filter_weekday_start() const {
+unsigned MainWindow::get_filter_weekday_start() const {
     /*
      * Get filter day from options.
-     * @return filter_day: a date object for the filter day.
+     * @return filter_day: the weekday the week starts on, 0 (Sunday) to 6 (Saturday).
      */
 
-    std::chrono::weekday filter_day{};
-
-    // Get date to filter on
-    if (options.weekday_start == "Monday") {
-        filter_day = std::chrono::Monday;
-    } else if (options.weekday_start == "Tuesday") {
-        filter_day = std::chrono::Tuesday;
-    } else if (options.weekday_start == "Wednesday") {
-        filter_day = std::chrono::Wednesday;
-    } else if (options.weekday_start == "Thursday") {
-        filter_day = std::chrono::Thursday;
-    } else if (options.weekday_start == "Friday") {
-        filter_day = std::chrono::Friday;
-    } else {
-        filter_day = std::chrono::Sunday;
-    }
-
-    return filter_day;
+    return civil_date::weekday_from_name(options.weekday_start);
 }
 
-std::tuple<std::chrono::year_month_day, std::string> MainWindow::get_filter_date() {
+std::tuple<int, std::string> MainWindow::get_filter_date() {
     /*
      * Get the date and day of week for the filter date specified in the options.
-     * @return: Tuple containing the start date (a date::year_month_day object) and weekday name (string).
+     * @return: Tuple containing the start date (a day number) and weekday name (string).
      */
 
-    std::chrono::year_month_day start_date{};
+    int start_day;
     std::string weekday_name;
 
-    const std::chrono::weekday filter_day = get_filter_weekday_start();
-
     // get_local_date returns a string in the form of YYYY-MM-DD
-    const std::string query_date = utilities::get_local_date();
-
-    // Back to date object
-    std::tm tm = {};
-    std::stringstream ss(query_date);
-    ss >> std::get_time(&tm,"%Y-%m-%d");
-    const auto tp = std::chrono::floor<std::chrono::days>(std::chrono::system_clock::from_time_t(std::mktime(&tm)));
+    const int today {civil_date::from_iso(utilities::get_local_date())};
 
     // Get date of last filter_day
     if (options.date_calculation_method == "Fixed") {
         std::cout << "Using fixed date method" << std::endl;
-        start_date = tp - (std::chrono::weekday{tp} - filter_day);
+        start_day = civil_date::week_start(today, get_filter_weekday_start());
         weekday_name = options.weekday_start;
     } else {  // Don't include day 7 days ago.
         std::cout << "Using rolling date method" << std::endl;
-        start_date = tp - std::chrono::days{6};
-
-        // Get weekday name
-        const std::chrono::weekday one_week = std::chrono::weekday(tp - std::chrono::days{7});
-        const unsigned weekday = one_week.iso_encoding();
-        weekday_name = get_weekday_name(weekday);
+        start_day = today - 6;
+        weekday_name = civil_date::weekday_name(civil_date::weekday(today - 7));
     }
 
-    return std::make_tuple(start_date, weekday_name);
+    return std::make_tuple(start_day, weekday_name);
 }
 
 void MainWindow::update_stats_if_new_day() {
@@ -693,41 +727,22 @@ void MainWindow::update_stats_if_new_day() {
      * Update the stats panel if day of the week isn't the same as the date in stats panel.
      */
 
-    const std::time_t t = std::time(nullptr);
-    std::stringstream ssTp;
-    ssTp << std::put_time(std::localtime(&t), "%A");
-    std::string weekday_name = ssTp.str();
+    const std::string weekday_name {
+        civil_date::weekday_name(civil_date::weekday(civil_date::from_iso(utilities::get_local_date())))};
 
     if (ui->drinksThisWeekLabel->text().toStdString().find(weekday_name) == std::string::npos) {
         update_stat_panel();
     }
 }
 
-std::string MainWindow::format_date(std::chrono::year_month_day date) {
-    /*
-     * Format date for use in DB filter.
-     * @return: formatted date string.
-     */
-
-    const std::string year = std::to_string((int)date.year());
-
-    const std::string month = utilities::zero_pad_string((unsigned)date.month());
-    const std::string day = utilities::zero_pad_string((unsigned)date.day());
-
-    const std::string query_date = year + "-" + month + "-" + day;
-
-    return query_date;
-}
-
 void MainWindow::open_graphs() {
     /*
      * Create graphs of drink data.
      */
 
+    // The window reads the drinks on a thread of its own, so it opens without waiting for them
     const std::string db_path = utilities::get_db_path();
-    const std::vector<Drink> all_drinks = Database::read(storage);
-    const double std_drink_size = get_std_drink_size_from_options();
-    auto *graphing_window = new Graphing(all_drinks, std_drink_size, options);
+    auto *graphing_window = new Graphing(db_path, SettingsSnapshot::current()->std_drink_size, options);
     graphing_window->setAttribute(Qt::WA_DeleteOnClose); // Delete pointer on window close
     graphing_window->setModal(false);
     graphing_window->show();
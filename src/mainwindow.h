@@ -3,10 +3,17 @@
 
 #include <QtWidgets/QMainWindow>
 #include "database.h"
+#include "drink_repository.h"
+#include "drink_query.h"
+#include "stats_engine.h"
 #include "../include/qcustomplot.h"
 #include "../ui/ui_mainwindow.h"
 #include "options.h"
 #include "drink_standards.h"
+#include "drink_table_model.h"
+#include "refresh_coordinator.h"
+#include <QSortFilterProxyModel>
+#include <QStringListModel>
 
 class MainWindow : public QMainWindow {
 Q_OBJECT
@@ -20,35 +27,43 @@ public:
 
 private:
     Ui::MainWindow *ui;
-    Storage storage = initStorage(utilities::get_db_path());
+    DrinkRepository repository {utilities::get_db_path()};
+    Storage &storage {repository.storage()};
+    DrinkTableModel *drink_table_model {nullptr};
+    QSortFilterProxyModel *drink_table_proxy {nullptr};
+    QStringListModel *filter_text_model {nullptr};
+    RefreshCoordinator refresh {[this] { QMetaObject::invokeMethod(this, [this] { flush_refresh(); },
+                                                                   Qt::QueuedConnection); }};
 
     void populate_filter_menus(const std::string &filter_type);
 
     void update_beer_fields();
+    void update_beer_fields(std::vector<Drink> all_beers);
 
     void update_stat_panel();
 
     void update_liquor_fields();
+    void update_liquor_fields(std::vector<Drink> all_liquor);
 
     void update_wine_fields();
+    void update_wine_fields(std::vector<Drink> all_wine);
 
     void rename_duplicate_drink_names(std::vector<Drink> &drinks);
     void update_drinks_this_week(double standard_drinks, const std::string& weekday_name);
     void update_standard_drinks_left_this_week(double std_drinks_consumed);
-    double update_vol_alcohol_consumed_this_week(const std::vector<Drink>& drinks_this_week, const std::string& weekday_name);
+    double update_vol_alcohol_consumed_this_week(double volume_consumed, const std::string& weekday_name);
     void update_volume_alcohol_remaining(double volume_alcohol_consumed);
-    void update_favorite_producer(const std::string& drink_type);
-    void update_favorite_drink(const std::string& drink_type);
-    void update_favorite_type(const std::string& drink_type);
-    void update_mean_abv(const std::string& drink_type);
-    void update_mean_ibu(const std::string& drink_type);
+    void update_favorite_producer(const StatsSnapshot& stats, const std::string& drink_type);
+    void update_favorite_drink(const StatsSnapshot& stats, const std::string& drink_type);
+    void update_favorite_type(const StatsSnapshot& stats, const std::string& drink_type);
+    void update_mean_abv(const StatsSnapshot& stats, const std::string& drink_type);
+    void update_mean_ibu(const StatsSnapshot& stats, const std::string& drink_type);
     void update_types_and_producers();
     std::string get_latest_notes(const std::string& name);
     std::string get_current_tab();
     Drink get_drink_attributes_from_fields();
     void update_selected_row(QItemSelectionModel* select, Drink entered_drink);
     void add_new_row(Drink entered_drink);
-    std::vector<std::set<QString>> generate_filter_item_sets();
     static QDate format_date_for_input(const Drink& drink);
     void populate_beer_fields(const Drink& drink_at_row);
     void populate_liquor_fields(const Drink& drink_at_row);
@@ -65,14 +80,16 @@ private:
     void add_slot_connections();
     void set_input_states();
     Drink get_drink_at_selected_row();
+    [[nodiscard]] int source_row(int view_row) const;
+    DrinkQuery table_filter_query();
+    void patch_table_row(const Drink& drink);
+    void flush_refresh();
     void clear_fields(const std::string& alcohol_type);
-    [[nodiscard]] std::chrono::weekday get_filter_weekday_start() const;
-    std::tuple<std::chrono::year_month_day, std::string> get_filter_date();
-    void update_std_drinks_today();
-    static std::string format_date(std::chrono::year_month_day date);
-    static std::string get_weekday_name(unsigned weekday_number);
+    [[nodiscard]] unsigned get_filter_weekday_start() const;
+    std::tuple<int, std::string> get_filter_date();
+    void update_std_drinks_today(const StatsSnapshot& stats);
+    static QString top_values_tooltip(const std::string& heading, const std::vector<ValueCount>& top_values);
     void open_graphs();
-    double get_std_drink_size_from_options();
 
 private slots:
     void submit_button_clicked();
@@ -84,6 +101,7 @@ private slots:
     void changed_filter_text(const QString&);
     void open_user_settings();
     static void open_about_dialog();
+    void open_import_dialog();
     void open_export_dialog();
     void open_std_drink_calculator() const;
     void reset_table_sort();
@@ -0,0 +1,74 @@
+#include "refresh_coordinator.h"
+#include <utility>
+
+RefreshCoordinator::RefreshCoordinator(std::function<void()> in_schedule) : schedule(std::move(in_schedule)) {
+    /*
+     * @param in_schedule: Arranges for the owner's flush to run once, later. The main window posts it to its event
+     * loop.
+     */
+}
+
+void RefreshCoordinator::begin_action(const std::string &in_action, const unsigned long long reads_so_far) {
+    /*
+     * Start tallying reads for a user action. With no flush due, any earlier action that never marked a view is
+     * dropped, so its name and reads aren't logged against a later flush. Otherwise the action joins the one whose
+     * flush is due, since that flush refreshes for both.
+     * @param in_action: Name of the action, for the log.
+     * @param reads_so_far: The repository's read count before the action.
+     */
+
+    if (dirty == 0) {
+        action = in_action;
+        reads_at_start = reads_so_far;
+    } else {
+        action += action.empty() ? in_action : " + " + in_action;
+    }
+}
+
+ActionReads RefreshCoordinator::end_action(const unsigned long long reads_so_far) {
+    /*
+     * Stop tallying reads for the current action.
+     * @param reads_so_far: The repository's read count after the action's flush.
+     * @return: The action and the reads it made.
+     */
+
+    ActionReads result {action, reads_so_far - reads_at_start};
+    action.clear();
+    reads_at_start = reads_so_far;
+    return result;
+}
+
+void RefreshCoordinator::mark(const unsigned views) {
+    /*
+     * Mark views as stale, scheduling a flush unless one is already due.
+     * @param views: View flags, or'ed together.
+     */
+
+    if (views == 0) {
+        return;
+    }
+    const bool scheduled {dirty != 0};
+    dirty |= views;
+    if (!scheduled && schedule) {
+        schedule();
+    }
+}
+
+bool RefreshCoordinator::pending() const {
+    /*
+     * Whether any view is waiting for the next flush.
+     */
+
+    return dirty != 0;
+}
+
+unsigned RefreshCoordinator::take() {
+    /*
+     * Take the stale views for a flush. Marks made while it runs schedule another one.
+     * @return: View flags, or'ed together.
+     */
+
+    const unsigned views {dirty};
+    dirty = 0;
+    return views;
+}
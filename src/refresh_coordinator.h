@@ -0,0 +1,45 @@
+#ifndef BUZZBOT_REFRESH_COORDINATOR_H
+#define BUZZBOT_REFRESH_COORDINATOR_H
+
+#include <functional>
+#include <string>
+
+struct ActionReads {
+    std::string action;
+    unsigned long long reads {0};
+};
+
+class RefreshCoordinator {
+    /*
+     * Batches the refreshes that writes make necessary. A write marks the views derived from the drinks table that it
+     * made stale. The first mark schedules one flush for the next turn of the event loop; marks made before then only
+     * add to it. The flush takes every marked view at once, so each is recomputed once however many writes marked it.
+     * Also tallies the database reads made between the start of a user action and the end of its flush.
+     */
+
+public:
+    enum View : unsigned {
+        Stats = 1U << 0,
+        EntryFields = 1U << 1,  // Name, type and producer dropdowns of all three tabs
+        EntryDate = 1U << 2,  // Set the current tab's date back to today
+        Table = 1U << 3,  // Start the drink log over from its first page
+    };
+
+    explicit RefreshCoordinator(std::function<void()> in_schedule);
+
+    void begin_action(const std::string &in_action, unsigned long long reads_so_far);
+    ActionReads end_action(unsigned long long reads_so_far);
+
+    void mark(unsigned views);
+    [[nodiscard]] bool pending() const;
+    unsigned take();
+
+private:
+    std::function<void()> schedule;
+    unsigned dirty {0};
+    std::string action;
+    unsigned long long reads_at_start {0};
+};
+
+
+#endif //BUZZBOT_REFRESH_COORDINATOR_H
@@ -0,0 +1,56 @@
+#include "settings_snapshot.h"
+#include "drink_standards.h"
+#include <mutex>
+#include <string>
+
+namespace {
+    std::mutex snapshot_mutex;
+    std::shared_ptr<const SettingsSnapshot> current_snapshot;
+}
+
+SettingsSnapshot::SettingsSnapshot(const Options &in_options) :
+    options(in_options), std_drink_size(resolve_std_drink_size(in_options)) {}
+
+std::shared_ptr<const SettingsSnapshot> SettingsSnapshot::current() {
+    /*
+     * Get the active settings snapshot, reading the settings file only if no snapshot exists yet.
+     * @return: A shared pointer to the current snapshot. It stays valid even if a new snapshot is published.
+     */
+
+    const std::lock_guard<std::mutex> lock(snapshot_mutex);
+    if (!current_snapshot) {
+        current_snapshot = std::make_shared<const SettingsSnapshot>(Options());  // Reads options from FS
+    }
+
+    return current_snapshot;
+}
+
+void SettingsSnapshot::publish(const Options &new_options) {
+    /*
+     * Replace the active snapshot. Holders of the previous snapshot keep a consistent copy until they release it.
+     * @param new_options: The options that should be used from now on.
+     */
+
+    auto new_snapshot {std::make_shared<const SettingsSnapshot>(new_options)};
+    const std::lock_guard<std::mutex> lock(snapshot_mutex);
+    current_snapshot.swap(new_snapshot);
+}
+
+double SettingsSnapshot::resolve_std_drink_size(const Options &in_options) {
+    /*
+     * Get standard drink size from either options or the country map.
+     * @param in_options: An options instance.
+     * @return: Standard drink size, in oz.
+     */
+
+    if (in_options.std_drink_country == "Custom") {
+        return std::stod(in_options.std_drink_size);
+    }
+
+    const auto country {std_drink_standards.find(in_options.std_drink_country)};
+    if (country == std_drink_standards.end()) {
+        return std_drink_standards.at("United States");
+    }
+
+    return country->second;
+}
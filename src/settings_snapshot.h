@@ -0,0 +1,27 @@
+#ifndef BUZZBOT_SETTINGS_SNAPSHOT_H
+#define BUZZBOT_SETTINGS_SNAPSHOT_H
+
+#include "options.h"
+#include <memory>
+
+class SettingsSnapshot {
+    /*
+     * Immutable, process-wide copy of the user settings. The settings file is parsed once, on first use, and the
+     * snapshot is replaced as a whole when the user accepts new settings. Readers never touch the filesystem.
+     */
+
+public:
+    explicit SettingsSnapshot(const Options &in_options);
+
+    const Options options;
+    const double std_drink_size;  // Oz. of pure alcohol in one standard drink, resolved from country or custom size
+
+    static std::shared_ptr<const SettingsSnapshot> current();
+    static void publish(const Options &new_options);
+
+private:
+    static double resolve_std_drink_size(const Options &in_options);
+};
+
+
+#endif //BUZZBOT_SETTINGS_SNAPSHOT_H
@@ -0,0 +1,40 @@
+#ifndef BUZZBOT_SQLITE_STATEMENT_H
+#define BUZZBOT_SQLITE_STATEMENT_H
+
+#include <sqlite3.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+// Owns a raw prepared statement for the few queries that bypass sqlite_orm, and finalizes it when done.
+struct StatementDeleter {
+    void operator()(sqlite3_stmt *statement) const {
+        sqlite3_finalize(statement);
+    }
+};
+using Statement = std::unique_ptr<sqlite3_stmt, StatementDeleter>;
+
+inline Statement prepare_statement(sqlite3 *db, const std::string &sql) {
+    /*
+     * Prepare a statement, throwing if the SQL is invalid.
+     * @param db: An open connection, e.g. from Database::connection().
+     * @param sql: The statement to prepare.
+     */
+
+    sqlite3_stmt *raw_statement {nullptr};
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &raw_statement, nullptr) != SQLITE_OK) {
+        throw std::runtime_error("Failed to prepare \"" + sql + "\": " + sqlite3_errmsg(db));
+    }
+    return Statement {raw_statement};
+}
+
+inline std::string column_text(sqlite3_stmt *statement, const int index) {
+    /*
+     * Read a TEXT column. NULL reads as an empty string.
+     */
+
+    const auto *text = reinterpret_cast<const char *>(sqlite3_column_text(statement, index));
+    return text ? std::string(text, static_cast<std::size_t>(sqlite3_column_bytes(statement, index))) : "";
+}
+
+#endif //BUZZBOT_SQLITE_STATEMENT_H
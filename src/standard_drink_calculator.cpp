@@ -6,9 +6,11 @@
 #include "calculate.h"
 #include <iostream>
 
-StandardDrinkCalc::StandardDrinkCalc(const double std_drink_size, const std::string& units) {
+StandardDrinkCalc::StandardDrinkCalc(const double in_std_drink_size, const std::string& units) :
+    std_drink_size(in_std_drink_size) {
     /*
      * UI for calculating standard drinks based on ABV & drink volume.
+     * @param in_std_drink_size: Size of a standard drink, in oz.
      */
 
     ui.setupUi(this);
@@ -29,7 +31,7 @@ void StandardDrinkCalc::volume_changed() {
     drink.set_size(ui.volumeInput->value());
     drink.set_abv(ui.abvInput->value());
 
-    const double std_drink {drink.get_standard_drinks()};
+    const double std_drink {drink.get_standard_drinks(std_drink_size)};
     if (std_drink > 0) {
         std::string standard_drinks = Calculate::double_to_string(std_drink);
         ui.standardDrinksOutput->setText(QString::fromStdString(standard_drinks));
@@ -47,7 +49,7 @@ void StandardDrinkCalc::abv_changed() {
     drink.set_size(ui.volumeInput->value());
     drink.set_abv(ui.abvInput->value());
 
-    const double std_drink {drink.get_standard_drinks()};
+    const double std_drink {drink.get_standard_drinks(std_drink_size)};
     if (std_drink > 0) {
         std::string standard_drinks = Calculate::double_to_string(std_drink);
         ui.standardDrinksOutput->setText(QString::fromStdString(standard_drinks));
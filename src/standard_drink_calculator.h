@@ -20,6 +20,9 @@ public:
     explicit StandardDrinkCalc(double std_drink_size = 0.6, const std::string& units = "Imperial");
     ~StandardDrinkCalc();
 
+private:
+    double std_drink_size;
+
 private slots:
     void volume_changed();
     void abv_changed();
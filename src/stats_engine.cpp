@@ -0,0 +1,23 @@
+#include "stats_engine.h"
+#include "aggregate_store.h"
+
+StatsSnapshot StatsEngine::compute(Storage &storage, const std::string &alcohol_type, const std::string &week_start,
+                                   const std::string &today, const double &std_drink_size) {
+    /*
+     * Calculate every value in the stats panel with one scan of the drinks table. Matches the separate Calculate
+     * functions: favorite_*, mean_abv, mean_ibu and streaks.
+     * @param storage: A storage instance.
+     * @param alcohol_type: The alcohol type for favorites and means, i.e. the current tab.
+     * @param week_start: First date of the week, YYYY-MM-DD.
+     * @param today: Today's date, YYYY-MM-DD.
+     * @param std_drink_size: Size of a standard drink, in oz.
+     * @return: The panel values.
+     */
+
+    AggregateStore aggregates;
+    aggregates.rebuild(storage, std_drink_size);
+
+    StatsSnapshot stats {aggregates.snapshot(alcohol_type, week_start, today)};
+    stats.rows_scanned = aggregates.size();
+    return stats;
+}
@@ -0,0 +1,36 @@
+#ifndef BUZZBOT_STATS_ENGINE_H
+#define BUZZBOT_STATS_ENGINE_H
+
+#include "calculate.h"
+#include "database.h"
+#include "drink_query.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct StatsSnapshot {
+    double std_drinks_this_week {0.0};
+    double alcohol_volume_this_week {0.0};  // oz
+    double std_drinks_today {0.0};
+    std::string favorite_producer;  // Empty if no drinks of the alcohol type
+    std::string favorite_drink;
+    std::string favorite_type;
+    std::vector<ValueCount> top_producers;  // Most common first, up to StatsEngine::top_count
+    std::vector<ValueCount> top_drinks;
+    std::vector<ValueCount> top_types;
+    double mean_abv {0.0};  // NaN if no drinks of the alcohol type
+    double mean_ibu {0.0};  // NaN if no drinks of the alcohol type have an IBU
+    Streaks streaks;
+    std::size_t rows_scanned {0};
+};
+
+class StatsEngine {
+public:
+    static constexpr int top_count {5};
+
+    static StatsSnapshot compute(Storage &storage, const std::string &alcohol_type, const std::string &week_start,
+                                 const std::string &today, const double &std_drink_size);
+};
+
+
+#endif //BUZZBOT_STATS_ENGINE_H
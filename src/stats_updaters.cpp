@@ -5,32 +5,32 @@
 #include "mainwindow.h"
 #include "calculate.h"
 #include "utilities.h"
+#include "settings_snapshot.h"
+#include "stats_engine.h"
+#include "civil_date.h"
 #include <iostream>
 
 void MainWindow::update_stat_panel() {
     /*
-     * Calculate number of standard drinks consumed since Sunday.
+     * Calculate number of standard drinks consumed since Sunday, and the rest of the stat panel, from the running
+     * totals kept by the repository.
      */
 
-    double standard_drinks = 0;
     const std::string current_tab = get_current_tab();
 
     // Get filter day & day of week.
-    const std::tuple<std::chrono::year_month_day, std::string> filter_date_results = get_filter_date();
+    const std::tuple<int, std::string> filter_date_results = get_filter_date();
 
-    const std::chrono::year_month_day start_date = std::get<0>(filter_date_results);
+    const int start_day = std::get<0>(filter_date_results);
     const std::string weekday_name = std::get<1>(filter_date_results);
 
-    const std::string query_date = format_date(start_date);
+    const std::string query_date = civil_date::to_iso(start_day);
 
     std::cout << "Calculating stats since " << query_date << ", which is last " << weekday_name << std::endl;
 
-    const std::vector<Drink> drinks_this_week = Database::filter("After Date", query_date, storage);
-
-    std::cout << "Using std drink size of " << options.std_drink_size << " in stats calculation" << std::endl;
-    for (const auto& drink : drinks_this_week) {
-        standard_drinks += drink.get_standard_drinks();
-    }
+    const double std_drink_size {SettingsSnapshot::current()->std_drink_size};
+    std::cout << "Using std drink size of " << std_drink_size << " in stats calculation" << std::endl;
+    const StatsSnapshot stats = repository.stats(current_tab, query_date, utilities::get_local_date(), std_drink_size);
 
     if (options.units == "Imperial") {
         ui->volAlcoholConsumedLabel->setText("Oz. alcohol consumed:");
@@ -41,19 +41,23 @@ void MainWindow::update_stat_panel() {
     }
 
     // Update the individual elements of the stat pane
-    update_drinks_this_week(standard_drinks, weekday_name);
-    update_standard_drinks_left_this_week(standard_drinks);
+    update_drinks_this_week(stats.std_drinks_this_week, weekday_name);
+    update_standard_drinks_left_this_week(stats.std_drinks_this_week);
 
     // update_vol_alcohol_consumed_this_week returns either ml or oz, depending on setting
-    const double vol_alc_consumed = update_vol_alcohol_consumed_this_week(drinks_this_week, weekday_name);
+    const double vol_alc_consumed = update_vol_alcohol_consumed_this_week(stats.alcohol_volume_this_week, weekday_name);
     update_volume_alcohol_remaining(vol_alc_consumed);
-    update_favorite_producer(current_tab);
-    update_favorite_drink(current_tab);
-    update_favorite_type(current_tab);
-    update_mean_abv(current_tab);
-    update_mean_ibu(current_tab);
-    update_std_drinks_today();
-    ui->consecutiveConsumptionLabel->setText(QString::fromStdString(std::to_string(Calculate::days_in_row(storage))));
+    update_favorite_producer(stats, current_tab);
+    update_favorite_drink(stats, current_tab);
+    update_favorite_type(stats, current_tab);
+    update_mean_abv(stats, current_tab);
+    update_mean_ibu(stats, current_tab);
+    update_std_drinks_today(stats);
+    ui->consecutiveConsumptionLabel->setText(QString::fromStdString(std::to_string(stats.streaks.current)));
+    ui->consecutiveConsumptionLabel->setToolTip(QString::fromStdString(
+            "Longest streak: " + std::to_string(stats.streaks.longest) + " days\n" +
+            "Days since last drink: " + std::to_string(stats.streaks.current_dry) + "\n" +
+            "Longest dry streak: " + std::to_string(stats.streaks.longest_dry) + " days"));
 }
 
 void MainWindow::update_drinks_this_week(double standard_drinks, const std::string& weekday_name) {
@@ -88,35 +92,22 @@ void MainWindow::update_standard_drinks_left_this_week(double std_drinks_consume
     }
 }
 
-double MainWindow::update_vol_alcohol_consumed_this_week(const std::vector<Drink>& drinks_this_week, const std::string& weekday_name) {
+double MainWindow::update_vol_alcohol_consumed_this_week(double volume_consumed, const std::string& weekday_name) {
     /*
      * Update the volume alcohol consumed output label to the total amount alcohol consumed this week.
-     * @param drinks_this_week: A vector of Drinks containing the drinks consumed in the past week.
+     * @param volume_consumed: Volume of alcohol consumed since the start of the week, in oz.
      * @param weekday_name: The day the week began on.
      */
 
-    double volume_consumed = 0;
-
     std::string units = "Oz.";
     if (options.units == "Metric") {
         units = "ml";
+        // Everything is stored in DB as oz. Convert back to ml for display.
+        volume_consumed = Calculate::oz_to_ml(volume_consumed);
     }
     const std::string volumeThisWeekLabelText = units + " alcohol since " + weekday_name + ":";
     ui->volAlcoholConsumedLabel->setText(QString::fromStdString(volumeThisWeekLabelText));
 
-    // Calculate total volume for the week
-    for (const auto& drink : drinks_this_week) {
-        double drinks_vol_alcohol;
-        if (options.units == "Imperial") {
-            drinks_vol_alcohol = (drink.get_abv() / 100) * drink.get_size();
-        } else {
-            // Everything is stored in DB as oz. Convert back to ml for display.
-            const double drink_size = Calculate::oz_to_ml(drink.get_size());
-            drinks_vol_alcohol = (drink.get_abv() / 100) * drink_size;
-        }
-        volume_consumed += drinks_vol_alcohol;
-    }
-
     if (volume_consumed == 0.0) {
         ui->volAlcoholConsumedOutput->setText("0.0");
     } else {
@@ -158,49 +149,51 @@ void MainWindow::update_volume_alcohol_remaining(double volume_alcohol_consumed)
     }
 }
 
-void MainWindow::update_favorite_producer(const std::string& drink_type) {
+void MainWindow::update_favorite_producer(const StatsSnapshot& stats, const std::string& drink_type) {
     /*
      * Update the favorite brewery text label to the most common drink in the database.
      */
 
-    std::string favorite_producer = Calculate::favorite_producer(storage, drink_type);
+    std::string favorite_producer = stats.favorite_producer;
     if (favorite_producer.empty()) {
         favorite_producer = "No " + drink_type + " entered";
     }
     ui->favoriteProducerOutput->setText(QString::fromStdString(favorite_producer));
+    ui->favoriteProducerOutput->setToolTip(top_values_tooltip("producers", stats.top_producers));
 }
 
-void MainWindow::update_favorite_drink(const std::string& drink_type) {
+void MainWindow::update_favorite_drink(const StatsSnapshot& stats, const std::string& drink_type) {
     /*
      * Update the favorite beer text label to the most common beer in the database.
      */
 
-    std::string favorite_drink = Calculate::favorite_drink(storage, drink_type);
+    std::string favorite_drink = stats.favorite_drink;
     if (favorite_drink.empty()) {
         favorite_drink = "No " + drink_type + " entered";
     }
     ui->favoriteDrinkOutput->setText(QString::fromStdString(favorite_drink));
+    ui->favoriteDrinkOutput->setToolTip(top_values_tooltip("drinks", stats.top_drinks));
 }
 
-void MainWindow::update_mean_abv(const std::string& drink_type) {
+void MainWindow::update_mean_abv(const StatsSnapshot& stats, const std::string& drink_type) {
     /*
      * Update the mean ABV text label to the mean ABV of all drinks in the database.
      */
 
-    std::string mean_abv = Calculate::double_to_string(Calculate::mean_abv(storage, drink_type));
+    std::string mean_abv = Calculate::double_to_string(stats.mean_abv);
     if (mean_abv == "nan" || mean_abv.empty()) {
         mean_abv = "No " + drink_type + " entered";
     }
     ui->avgAbvDrinkOutput->setText(QString::fromStdString(mean_abv));
 }
 
-void MainWindow::update_mean_ibu(const std::string& drink_type) {
+void MainWindow::update_mean_ibu(const StatsSnapshot& stats, const std::string& drink_type) {
     /*
      * Set the mean IBU text label to the mean IBU of all beers in the database.
      */
 
     if (drink_type == "Beer") {
-        std::string mean_ibu = Calculate::double_to_string(Calculate::mean_ibu(storage, drink_type));
+        std::string mean_ibu = Calculate::double_to_string(stats.mean_ibu);
         if (mean_ibu == "nan" || mean_ibu.empty()) {
             mean_ibu = "No " + drink_type + " entered";
         }
@@ -208,76 +201,43 @@ void MainWindow::update_mean_ibu(const std::string& drink_type) {
     }
 }
 
-void MainWindow::update_std_drinks_today() {
+void MainWindow::update_std_drinks_today(const StatsSnapshot& stats) {
     /*
-     * Calculate standard drinks consumed today & update the line in the stats panel.
+     * Update the standard drinks consumed today line in the stats panel.
      */
 
-    double std_drinks_today {0.0};
-
-    const std::string query_date = utilities::get_local_date();
-
-    const std::vector<Drink> drinks_today = Database::filter("After Date", query_date, storage);
-
-    for (auto& drink : drinks_today) {
-        std_drinks_today += drink.get_standard_drinks();
-    }
-
-    ui->stdDrinksTodayOutput->setText(QString::fromStdString(Calculate::double_to_string(std_drinks_today)));
+    ui->stdDrinksTodayOutput->setText(QString::fromStdString(Calculate::double_to_string(stats.std_drinks_today)));
 }
 
-void MainWindow::update_favorite_type(const std::string& drink_type) {
+void MainWindow::update_favorite_type(const StatsSnapshot& stats, const std::string& drink_type) {
     /*
      * Set the favoriteTypeOutput to the most common drink found in the database.
      */
 
-    std::string fave_type = Calculate::favorite_type(storage, drink_type);
+    std::string fave_type = stats.favorite_type;
     if (fave_type.empty()) {
         fave_type = "No " + drink_type + " entered";
     }
     ui->favoriteTypeOutput->setText(QString::fromStdString(fave_type));
+    ui->favoriteTypeOutput->setToolTip(top_values_tooltip("types", stats.top_types));
 }
 
-std::string MainWindow::get_weekday_name(unsigned int weekday_number) {
+QString MainWindow::top_values_tooltip(const std::string& heading, const std::vector<ValueCount>& top_values) {
     /*
-     * Get the name of the day of the week from the weekday number.
-     * @param weekday_number: An unsigned integer denoting weekday number (1-7).
-     * @return: The name of the day of the week.
+     * Build the tooltip listing the most common values behind a favorite, e.g. "Top 5 producers".
+     * @param heading: What the values are, in plural.
+     * @param top_values: The values and their counts, most common first.
+     * @return: One line per value, or an empty string if there are no values.
      */
 
-    std::string day_name;
-    if (weekday_number == 1) {
-        day_name = "Monday";
-    } else if (weekday_number == 2) {
-        day_name = "Tuesday";
-    } else if (weekday_number == 3) {
-        day_name = "Wednesday";
-    } else if (weekday_number == 4) {
-        day_name = "Thursday";
-    } else if (weekday_number == 5) {
-        day_name = "Friday";
-    } else if (weekday_number == 6) {
-        day_name = "Saturday";
-    } else {
-        day_name = "Sunday";
+    if (top_values.empty()) {
+        return "";
     }
 
-    return day_name;
-}
-
-double MainWindow::get_std_drink_size_from_options() {
-    /*
-     * Get the std drink size for the selected country.
-     * @param country: The country for which to retrieve the size.
-     * @return: a double denoting the size of a standard drink.
-     */
-
-    double std_drink_size {0.6}; // Default to US
-    if (options.std_drink_country == "Custom") {
-        std_drink_size = std::stod(options.std_drink_size);
-    } else {
-        std_drink_size = std_drink_standards.find(options.std_drink_country)->second;
+    std::string tooltip {"Top " + std::to_string(top_values.size()) + " " + heading + ":"};
+    for (std::size_t i = 0; i < top_values.size(); i++) {
+        tooltip += "\n" + std::to_string(i + 1) + ". " + top_values[i].value + " (" +
+                   std::to_string(top_values[i].count) + ")";
     }
-
-    return std_drink_size;
+    return QString::fromStdString(tooltip);
 }
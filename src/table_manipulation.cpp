@@ -5,6 +5,7 @@
 #include "mainwindow.h"
 #include "confirm_dialog.h"
 #include "calculate.h"
+#include "settings_snapshot.h"
 #include <iostream>
 
 void MainWindow::update_selected_row(QItemSelectionModel* select, Drink entered_drink) {
@@ -17,11 +18,11 @@ void MainWindow::update_selected_row(QItemSelectionModel* select, Drink entered_
     ConfirmDialog confirmation_dialog = ConfirmDialog("Update");
     if (confirmation_dialog.exec() == QDialog::Accepted) {
         // Get the selected row
-        int selection = select->selectedRows().at(0).row();
-        int row_to_update = ui->drinkLogTable->item(selection, 10)->text().toUtf8().toInt();
+        int selection = source_row(select->selectedRows().at(0).row());
+        int row_to_update = drink_table_model->id_at(selection);
 
         // Get the existing timestamp
-        std::string timestamp = ui->drinkLogTable->item(selection, 11)->text().toStdString();
+        std::string timestamp = drink_table_model->timestamp_at(selection);
         std::cout << "Updating row " << row_to_update << " Timestamp: " << timestamp << std::endl;
 
         // Update the variables in the drink struct
@@ -32,7 +33,12 @@ void MainWindow::update_selected_row(QItemSelectionModel* select, Drink entered_
             entered_drink.set_size(Calculate::ml_to_oz(entered_drink.get_size()));
         }
 
-        Database::update(storage, entered_drink);
+        if (repository.update(entered_drink)) {
+            patch_table_row(entered_drink);
+        } else {  // Deleted outside the repository, e.g. by clearing the data
+            std::cout << "Row " << row_to_update << " no longer exists" << std::endl;
+            drink_table_model->remove_drink(row_to_update);
+        }
     }
 }
 
@@ -50,7 +56,8 @@ void MainWindow::add_new_row(Drink entered_drink) {
     if (options.units == "Metric") {
         entered_drink.set_size(Calculate::ml_to_oz(entered_drink.get_size()));
     }
-    Database::write(entered_drink, storage);
+    entered_drink.set_id(repository.insert(entered_drink));
+    patch_table_row(entered_drink);
 }
 
 void MainWindow::reset_fields() {
@@ -90,76 +97,15 @@ void MainWindow::reset_fields() {
 
 void MainWindow::update_table() {
     /*
-     * Populate the table with data from the database.
+     * Populate the table with data from the database. This starts the table over from the first page of drinks that
+     * pass the filter, so it's only for when the filter changes or many rows were written at once; single writes go
+     * through patch_table_row().
      */
 
-    // Temporarily sort by database ID to fix issues with blank rows
-    //ui->drinkLogTable->sortItems(9, Qt::AscendingOrder);
-
-    std::string filter_category = ui->filterCategoryInput->currentText().toStdString();
-    std::string filter_text = ui->filterTextInput->currentText().toStdString();
-
-    std::vector<Drink> drinks {};
-    if (filter_text.find(" -- (") != std::string::npos) {
-        drinks = Database::filter("Name & Producer", filter_text, storage);
-    } else {
-        drinks = Database::filter(filter_category, filter_text, storage);
-    }
-    Database::sort_by_date_id(drinks);
-
-    ui->drinkLogTable->setRowCount(0);
-    for (const Drink& drink : drinks) {
-        // These don't need to be deleted. The table widget takes ownership of these pointers and
-        // will delete them as needed.
-        int table_row_num = ui->drinkLogTable->rowCount();
-        ui->drinkLogTable->insertRow(table_row_num);
-        QDate date = QDate::fromString(QString::fromStdString(drink.get_date()), "yyyy-MM-dd");
-        auto *date_qtw = new QTableWidgetItem;
-        auto *name = new QTableWidgetItem(drink.get_name().c_str());
-        auto *type = new QTableWidgetItem(drink.get_type().c_str());
-        auto *subtype = new QTableWidgetItem(drink.get_subtype().c_str());
-        auto *producer = new QTableWidgetItem(drink.get_producer().c_str());
-        auto *abv = new QTableWidgetItem(Calculate::double_to_string(drink.get_abv()).c_str());
-        auto *standard_drinks = new QTableWidgetItem(Calculate::double_to_string(drink.get_standard_drinks()).c_str());
-        auto *rating = new QTableWidgetItem(std::to_string(drink.get_rating()).c_str());
-        auto *id = new QTableWidgetItem;
-        auto *timestamp = new QTableWidgetItem(drink.get_timestamp().c_str());
-        auto *sort_order =  new QTableWidgetItem(drink.get_sort_order());
-
-        // Calculate & Display size
-        double drink_size = drink.get_size();
-        if (options.units == "Metric") {
-            drink_size = Calculate::oz_to_ml(drink_size);
+    const double std_drink_size {SettingsSnapshot::current()->std_drink_size};
 
-            // Round to tenth place
-            drink_size = floor(drink_size * 10 + 0.5) / 10;
-        }
-        auto *size = new QTableWidgetItem(Calculate::double_to_string(drink_size).c_str());
-
-        // Sort ID numerically
-        id->setData(Qt::DisplayRole, drink.get_id());
-        sort_order->setData(Qt::DisplayRole, drink.get_sort_order());
-        date_qtw->setData(Qt::DisplayRole, date);
-
-        std::string notes = drink.get_notes();
-
-        // Handle blank IBU
-        auto *ibu = (drink.get_ibu() == -1.0) ? new QTableWidgetItem("") : new QTableWidgetItem(Calculate::double_to_string(drink.get_ibu()).c_str());
-
-        ui->drinkLogTable->setItem(table_row_num, 0, date_qtw);
-        ui->drinkLogTable->setItem(table_row_num, 1, name);
-        ui->drinkLogTable->setItem(table_row_num, 2, type);
-        ui->drinkLogTable->setItem(table_row_num, 3, subtype);
-        ui->drinkLogTable->setItem(table_row_num, 4, producer);
-        ui->drinkLogTable->setItem(table_row_num, 5, abv);
-        ui->drinkLogTable->setItem(table_row_num, 6, ibu);
-        ui->drinkLogTable->setItem(table_row_num, 7, size);
-        ui->drinkLogTable->setItem(table_row_num, 8, standard_drinks);
-        ui->drinkLogTable->setItem(table_row_num, 9, rating);
-        ui->drinkLogTable->setItem(table_row_num, 10, id);
-        ui->drinkLogTable->setItem(table_row_num, 11, timestamp);
-        ui->drinkLogTable->setItem(table_row_num, 12, sort_order);
-    }
+    // The model reads more pages as the table is scrolled, and formats only the cells the view draws
+    drink_table_model->set_query(storage, table_filter_query(), std_drink_size, options.units == "Metric");
     reset_table_sort();
 }
 
@@ -170,18 +116,18 @@ void MainWindow::delete_row() {
 
     ConfirmDialog confirmation_dialog = ConfirmDialog("Delete");
     if (confirmation_dialog.exec() == QDialog::Accepted) {
-        int select = ui->drinkLogTable->selectionModel()->currentIndex().row();
-        int row_to_delete = (ui->drinkLogTable->item(select, 10)->text().toUtf8().toInt());
+        refresh.begin_action("Delete", repository.reads());
+        int select = source_row(ui->drinkLogTable->selectionModel()->currentIndex().row());
+        int row_to_delete = drink_table_model->id_at(select);
         std::cout << "Deleting row " << row_to_delete << std::endl;
-        Database::delete_row(storage, row_to_delete);
-        update_table();
-        update_stat_panel();
+        if (!repository.remove(row_to_delete)) {
+            std::cout << "Row " << row_to_delete << " no longer exists" << std::endl;
+        }
+        drink_table_model->remove_drink(row_to_delete);
         ui->deleteRowButton->setDisabled(true);
 
-        // Update the fields to reflect deleted row
-        update_beer_fields();
-        update_liquor_fields();
-        update_wine_fields();
+        // Update the stats and fields to reflect deleted row
+        refresh.mark(RefreshCoordinator::Stats | RefreshCoordinator::EntryFields);
     }
 }
 
@@ -197,7 +143,7 @@ Drink MainWindow::get_drink_at_selected_row() {
 
     if (selection >= 0) {
         std::cout << "Getting row " << selection << " from table." << std::endl;
-        int row_to_get = ui->drinkLogTable->item(selection, 10)->text().toUtf8().toInt();
+        int row_to_get = drink_table_model->id_at(source_row(selection));
         std::cout << "Getting row " << row_to_get << " from database." << std::endl;
         if (select->isRowSelected(selection))
             ui->deleteRowButton->setEnabled(true);
@@ -245,7 +191,101 @@ void MainWindow::reset_table_sort() {
     /*
      * Reset table sort to default, by datetime descending.
      */
-    int sort_column = 12;
-    std::cout << "Sorting by column: " << ui->drinkLogTable->horizontalHeaderItem(sort_column)->text().toStdString() << std::endl;
-    ui->drinkLogTable->sortItems(sort_column, Qt::DescendingOrder);
+    int sort_column = DrinkTableModel::SortOrder;
+    std::cout << "Sorting by column: " << drink_table_model->headerData(sort_column, Qt::Horizontal).toString().toStdString() << std::endl;
+    ui->drinkLogTable->sortByColumn(sort_column, Qt::DescendingOrder);
+}
+
+DrinkQuery MainWindow::table_filter_query() {
+    /*
+     * Build the query for the drinks the table shows, from the filter category and text.
+     * @return: The query, with no ordering applied.
+     */
+
+    const std::string filter_category = ui->filterCategoryInput->currentText().toStdString();
+    const std::string filter_text = ui->filterTextInput->currentText().toStdString();
+
+    if (filter_text.find(" -- (") != std::string::npos) {
+        return DrinkQuery::from_filter("Name & Producer", filter_text);
+    }
+    return DrinkQuery::from_filter(filter_category, filter_text);
+}
+
+void MainWindow::patch_table_row(const Drink& drink) {
+    /*
+     * Show a drink that was just inserted or updated, touching only its row. Whether it still passes the filter is
+     * checked with one lookup by ID; a drink that no longer does is taken out of the table.
+     * @param drink: The drink as written, with its database ID.
+     */
+
+    if (table_filter_query().where(DrinkColumn::Id, drink.get_id()).count(storage) > 0) {
+        drink_table_model->update_drink(drink);
+    } else {
+        drink_table_model->remove_drink(drink.get_id());
+    }
+}
+
+void MainWindow::flush_refresh() {
+    /*
+     * Refresh every view marked stale since the last flush, each once. The three tabs' dropdowns share one read of the
+     * distinct names, types, subtypes and producers, instead of reading every drink once per tab.
+     * Logs how many reads the action behind the flush made.
+     */
+
+    const unsigned stale_views {refresh.take()};
+
+    if (stale_views & RefreshCoordinator::Table) {
+        update_table();
+    }
+
+    if (stale_views & RefreshCoordinator::EntryFields) {
+        std::vector<Drink> beers;
+        std::vector<Drink> liquors;
+        std::vector<Drink> wines;
+        const DrinkQuery entry_values {DrinkQuery().columns({DrinkColumn::AlcoholType, DrinkColumn::Name,
+                                                             DrinkColumn::Type, DrinkColumn::Subtype,
+                                                             DrinkColumn::Producer}).distinct()};
+        for (Drink& drink : entry_values.run(storage)) {
+            const std::string alcohol_type {drink.get_alcohol_type()};
+            if (alcohol_type == "Beer") {
+                beers.push_back(std::move(drink));
+            } else if (alcohol_type == "Liquor") {
+                liquors.push_back(std::move(drink));
+            } else if (alcohol_type == "Wine") {
+                wines.push_back(std::move(drink));
+            }
+        }
+        update_beer_fields(std::move(beers));
+        update_liquor_fields(std::move(liquors));
+        update_wine_fields(std::move(wines));
+    }
+
+    if (stale_views & RefreshCoordinator::EntryDate) {
+        const QDate todays_date = QDate::currentDate();
+        const std::string alcohol_type = get_current_tab();
+        if (alcohol_type == "Beer") {
+            ui->beerDateInput->setDate(todays_date);
+        } else if (alcohol_type == "Liquor") {
+            ui->liquorDateInput->setDate(todays_date);
+        } else if (alcohol_type == "Wine") {
+            ui->wineDateInput->setDate(todays_date);
+        }
+    }
+
+    if (stale_views & RefreshCoordinator::Stats) {
+        update_stat_panel();
+    }
+
+    const ActionReads action_reads {refresh.end_action(repository.reads())};
+    std::cout << action_reads.action << " made " << action_reads.reads << " database reads" << std::endl;
+}
+
+int MainWindow::source_row(const int view_row) const {
+    /*
+     * Map a row of the table view, which may be sorted, to the drink model's row.
+     * @param view_row: Row as shown in the table.
+     * @return: Row in drink_table_model, or -1 if view_row isn't a row.
+     */
+
+    return drink_table_proxy->mapToSource(drink_table_proxy->index(view_row, 0)).row();
 }
@@ -188,10 +188,20 @@ void UserSettings::clicked_clear_data() {
     if (confirmation_dialog.exec() == QDialog::Accepted) {
         Storage storage = initStorage(utilities::get_db_path());
         Database::truncate(storage);
+        cleared_data = true;
         std::cout << "*** Truncated the database ***" << std::endl;
     }
 }
 
+bool UserSettings::get_cleared_data() const {
+    /*
+     * Whether the user cleared the data while the dialog was open. The rows were deleted on the dialog's own
+     * connection, so anything the main window derived from them is stale, even if the dialog was cancelled.
+     */
+
+    return cleared_data;
+}
+
 std::string UserSettings::get_units() {
     /*
      * Get nuits
@@ -15,6 +15,7 @@ class UserSettings : public QDialog, public Ui::userSettingsDialog {
 
 Q_OBJECT
     Ui::userSettingsDialog ui{};
+    bool cleared_data {false};
 
 public:
     explicit UserSettings(const Options &options, const std::map<std::string, double> &country_info);
@@ -53,13 +54,15 @@ public:
 
     void set_database_path(const std::string &db_path);
 
+    [[nodiscard]] bool get_cleared_data() const;
+
 private slots:
 
     void changed_limit_setting();
 
     void changed_date_calc();
 
-    static void clicked_clear_data();
+    void clicked_clear_data();
 
     void clicked_browse_db_path();
 
@@ -4,7 +4,7 @@
 
 #include "options.h"
 #include "utilities.h"
-#include "drink_standards.h"
+#include "settings_snapshot.h"
 #include <QStandardPaths>
 #include <cmath>
 #include <fstream>
@@ -98,16 +98,7 @@ double utilities::get_std_drink_size() {
      * @return: Standard drink size
      */
 
-    Options options;  // Reads options from FS
-    double standard_drink_size{0.0};
-
-    if (options.std_drink_country == "Custom") {
-        standard_drink_size = std::stod(options.std_drink_size);
-    } else {
-        standard_drink_size = std_drink_standards.find(options.std_drink_country)->second;
-    }
-
-    return standard_drink_size;
+    return SettingsSnapshot::current()->std_drink_size;
 }
 
 std::string utilities::get_application_data_path() {
@@ -137,15 +128,15 @@ std::string utilities::get_db_path() {
      * @return full_path Path where database file should be stored.
      */
 
-    Options options;  // Reads options from FS
+    const auto settings {SettingsSnapshot::current()};
     std::string full_path{};
-    if (!options.custom_database) {
+    if (!settings->options.custom_database) {
         // Find get_db_path to application support directory
         const std::string directory{utilities::get_application_data_path()};
         full_path = directory + "/buzzbot.db";
         std::filesystem::create_directory(directory);
     } else {  // Custom DB get_db_path
-        full_path = options.database_path;
+        full_path = settings->options.database_path;
     }
 
     std::cout << "Using DB located at " << full_path << std::endl;
@@ -8,7 +8,17 @@
 
 void MainWindow::update_wine_fields() {
     /*
-     * Read rows in the DB and populate the winery, type, and name dropdowns with unique values.
+     * Read the wines in the DB and populate the wine dropdowns from them.
+     */
+
+    update_wine_fields(Database::filter("Alcohol Type", "Wine", storage));
+}
+
+void MainWindow::update_wine_fields(std::vector<Drink> all_wine) {
+    /*
+     * Populate the winery, type, and name dropdowns with unique values.
+     * @param all_wine: Wine drinks with at least their names, types, subtypes and producers. Passed in so one
+     * read can serve all three tabs.
      */
 
     std::set<QString> wineries;
@@ -17,8 +27,6 @@ void MainWindow::update_wine_fields() {
     std::vector<std::string> names_tmp;
     std::set<std::string> names;
 
-    std::vector<Drink> all_wine = Database::filter("Alcohol Type", "Wine", storage);
-
     // Block signals to avoid crashing
     QSignalBlocker winery_signal_blocker(ui->wineryInput);
     QSignalBlocker type_signal_blocker(ui->wineTypeInput);
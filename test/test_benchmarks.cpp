@@ -0,0 +1,369 @@
+//
+// Benchmarks are hidden from the default test run. Run them with: functions_test "[benchmark]"
+//
+
+#include "../src/database.h"
+#include "../src/drink_repository.h"
+#include "../src/exporters.h"
+#include "../src/importers.h"
+#include "../src/drink_query.h"
+#include "../src/calculate.h"
+#include "../src/stats_engine.h"
+#include "../src/civil_date.h"
+#include "../src/graphing_calculations.h"
+#include "../src/histogram.h"
+#include "../src/lod_pyramid.h"
+#include "../src/drink_columns.h"
+#include "../src/filter_dictionary.h"
+#include "test_helpers.h"
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#if __has_include("catch2/catch_test_macros.hpp")
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#else
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+#endif
+
+namespace {
+    const std::string bench_db_name {"benchdb.db"};
+
+    std::string bench_db_path() {
+        return std::string(std::filesystem::current_path()) + "/" + bench_db_name;
+    }
+
+    Drink bench_drink(const int day_of_month, const std::string &alcohol_type) {
+        Drink drink {make_test_drink("2022-01-" + utilities::zero_pad_string(day_of_month), "Mosaic",
+                                     "Community Brewing", 8.4, 75.0, alcohol_type)};
+        drink.set_timestamp("2022-01-01 00:00:00");
+        return drink;
+    }
+
+    void seed_bench_db(Storage &storage, const int row_count) {
+        Database::write_db_to_disk(storage);
+        storage.remove_all<Drink>();
+        auto guard = storage.transaction_guard();
+        for (int i = 0; i < row_count; i++) {
+            storage.insert(bench_drink(i % 28 + 1, (i % 3 == 0) ? "Liquor" : "Beer"));
+        }
+        guard.commit();
+    }
+}
+
+TEST_CASE("Per-query Storage Overhead", "[.benchmark]") {
+    std::remove(bench_db_path().c_str());
+    DrinkRepository repository(bench_db_path());
+    seed_bench_db(repository.storage(), 1000);
+
+    // Previous Database API: every call received a copy of the storage, which opens its own connection.
+    const auto read_by_value = [](Storage storage) {  // NOLINT(performance-unnecessary-value-param)
+        return Database::read_row(500, storage).get_id();
+    };
+    Storage unopened_storage = initStorage(bench_db_path());
+
+    BENCHMARK("Storage copied per query") {
+        return read_by_value(unopened_storage);
+    };
+
+    BENCHMARK("DrinkRepository connection by reference") {
+        return Database::read_row(500, repository.storage()).get_id();
+    };
+
+    std::remove(bench_db_path().c_str());
+}
+
+TEST_CASE("CSV Import", "[.benchmark]") {
+    const std::string csv_path {std::string(std::filesystem::current_path()) + "/bench_import.csv"};
+    std::remove(bench_db_path().c_str());
+    DrinkRepository repository(bench_db_path());
+    seed_bench_db(repository.storage(), 100000);
+    exporters::to_csv(repository.storage(), csv_path, "Imperial");
+
+    BENCHMARK("Import 100k rows") {
+        Database::drop_daily_totals_triggers(repository.storage());  // Clear the table without per-row triggers
+        repository.storage().remove_all<Drink>();
+        return importers::from_csv(csv_path, repository.storage()).imported;
+    };
+
+    std::remove(csv_path.c_str());
+    std::remove(bench_db_path().c_str());
+}
+
+TEST_CASE("Table Refresh Ordering", "[.benchmark]") {
+    std::remove(bench_db_path().c_str());
+    DrinkRepository repository(bench_db_path());
+    seed_bench_db(repository.storage(), 100000);
+    std::vector<Drink> drinks {Database::read(repository.storage())};
+    std::vector<Drink> shuffled {drinks};
+    std::reverse(shuffled.begin(), shuffled.end());
+
+    BENCHMARK("sort_by_date_id, ordered by SQL") {
+        Database::sort_by_date_id(drinks);
+        return drinks.size();
+    };
+
+    BENCHMARK_ADVANCED("sort_by_date_id, reversed")(Catch::Benchmark::Chronometer meter) {
+        std::vector<std::vector<Drink>> inputs(meter.runs(), shuffled);
+        meter.measure([&inputs](const int i) {
+            Database::sort_by_date_id(inputs[i]);
+            return inputs[i].size();
+        });
+    };
+
+    std::remove(bench_db_path().c_str());
+}
+
+TEST_CASE("Drink Table Load", "[.benchmark]") {
+    std::remove(bench_db_path().c_str());
+    DrinkRepository repository(bench_db_path());
+    seed_bench_db(repository.storage(), 100000);
+    std::vector<Drink> drinks {Database::read(repository.storage())};
+    Database::sort_by_date_id(drinks);
+
+    // What the table used to build per refresh: every cell formatted up front
+    BENCHMARK("Format every cell") {
+        std::size_t characters {0};
+        for (const Drink& drink : drinks) {
+            characters += drink.get_date().size() + drink.get_name().size() + drink.get_type().size() +
+                          drink.get_subtype().size() + drink.get_producer().size() +
+                          Calculate::double_to_string(drink.get_abv()).size() +
+                          Calculate::double_to_string(drink.get_ibu()).size() +
+                          Calculate::double_to_string(drink.get_size()).size() +
+                          Calculate::double_to_string(drink.get_standard_drinks(0.6)).size() +
+                          std::to_string(drink.get_rating()).size() + drink.get_timestamp().size();
+        }
+        return characters;
+    };
+
+    DrinkColumns columns;
+    BENCHMARK("DrinkColumns::assign") {
+        columns.assign(drinks);
+        return columns.size();
+    };
+
+    std::remove(bench_db_path().c_str());
+}
+
+TEST_CASE("Projected Reads", "[.benchmark]") {
+    std::remove(bench_db_path().c_str());
+    DrinkRepository repository(bench_db_path());
+    seed_bench_db(repository.storage(), 100000);
+    Database::execute(repository.storage(), "UPDATE drinks SET notes = printf('%.500c', 'x')");
+    const double std_drink_size {0.6};
+
+    BENCHMARK("Full Drink rows") {
+        double standard_drinks {0.0};
+        for (const auto &drink : Database::read(repository.storage())) {
+            standard_drinks += drink.get_standard_drinks(std_drink_size);
+        }
+        return standard_drinks;
+    };
+
+    BENCHMARK("DrinkFacts rows") {
+        double standard_drinks {0.0};
+        for (const auto &drink : DrinkQuery().order_by_date().facts(repository.storage())) {
+            standard_drinks += drink.standard_drinks(std_drink_size);
+        }
+        return standard_drinks;
+    };
+
+    std::remove(bench_db_path().c_str());
+}
+
+TEST_CASE("Stat Panel Refresh", "[.benchmark]") {
+    std::remove(bench_db_path().c_str());
+    DrinkRepository repository(bench_db_path());
+    seed_bench_db(repository.storage(), 100000);
+    const std::string week_start {"2022-01-23"};
+    const std::string today {"2022-01-28"};
+    const double std_drink_size {0.6};
+
+    // Previous update_stat_panel: one query per panel value, each reading its rows again.
+    BENCHMARK("Query per stat") {
+        double standard_drinks {0.0};
+        for (const auto &drink : DrinkQuery().on_or_after(week_start).facts(repository.storage())) {
+            standard_drinks += drink.standard_drinks(std_drink_size);
+        }
+        for (const auto &drink : DrinkQuery().on_or_after(today).facts(repository.storage())) {
+            standard_drinks += drink.standard_drinks(std_drink_size);
+        }
+        const std::string favorites {Calculate::favorite_producer(repository.storage(), "Beer") +
+                                     Calculate::favorite_drink(repository.storage(), "Beer") +
+                                     Calculate::favorite_type(repository.storage(), "Beer")};
+        return standard_drinks + Calculate::mean_abv(repository.storage(), "Beer") +
+               Calculate::mean_ibu(repository.storage(), "Beer") + static_cast<double>(favorites.size()) +
+               Calculate::days_in_row(repository.storage());
+    };
+
+    BENCHMARK("StatsEngine single pass") {
+        const StatsSnapshot stats {StatsEngine::compute(repository.storage(), "Beer", week_start, today,
+                                                        std_drink_size)};
+        return stats.std_drinks_this_week + stats.std_drinks_today + stats.mean_abv + stats.mean_ibu +
+               static_cast<double>(stats.favorite_producer.size() + stats.favorite_drink.size() +
+                                   stats.favorite_type.size() + stats.streaks.current);
+    };
+
+    std::remove(bench_db_path().c_str());
+}
+
+TEST_CASE("Stats Refresh After Insert", "[.benchmark]") {
+    std::remove(bench_db_path().c_str());
+    DrinkRepository repository(bench_db_path());
+    seed_bench_db(repository.storage(), 100000);
+    const Drink drink {bench_drink(28, "Beer")};
+    repository.stats("Beer", "2022-01-23", "2022-01-28", 0.6);
+
+    BENCHMARK("Full scan") {
+        return StatsEngine::compute(repository.storage(), "Beer", "2022-01-23", "2022-01-28", 0.6).std_drinks_today;
+    };
+
+    // Only the in-memory delta and snapshot; the insert itself costs the same either way
+    BENCHMARK("Aggregate delta") {
+        repository.aggregates().add(drink);
+        return repository.stats("Beer", "2022-01-23", "2022-01-28", 0.6).std_drinks_today;
+    };
+
+    std::remove(bench_db_path().c_str());
+}
+
+TEST_CASE("Filter Menu Values", "[.benchmark]") {
+    std::remove(bench_db_path().c_str());
+    DrinkRepository repository(bench_db_path());
+    seed_bench_db(repository.storage(), 100000);
+    repository.filters().values(repository.storage(), DrinkColumn::Producer);
+
+    BENCHMARK("Read every drink") {
+        std::set<std::string> producers;
+        for (const Drink &drink : Database::read(repository.storage())) {
+            producers.insert(drink.get_producer());
+        }
+        return producers.size();
+    };
+
+    BENCHMARK("Grouped query") {
+        return FilterDictionary().values(repository.storage(), DrinkColumn::Producer).size();
+    };
+
+    BENCHMARK("Cached values") {
+        return repository.filters().values(repository.storage(), DrinkColumn::Producer).size();
+    };
+
+    std::remove(bench_db_path().c_str());
+}
+
+TEST_CASE("Civil Date Week Keys", "[.benchmark]") {
+    std::vector<int> days(100000);
+    for (std::size_t i = 0; i < days.size(); i++) {
+        days[i] = civil_date::days_from_civil(2000, 1, 1) + static_cast<int>(i % 8000);
+    }
+
+    // Previous graph path: %W week number through strptime, back to a date, then mktime through a stringstream
+    const auto libc_week_key = [](const int yyyymmdd) {
+        struct tm week_tm{};
+        strptime(std::to_string(yyyymmdd).c_str(), "%Y%m%d", &week_tm);
+        const int delta {week_tm.tm_wday ? week_tm.tm_wday - 1 : 6};
+        const std::string week_num {std::to_string(yyyymmdd / 10000) + '-' +
+                                    std::to_string((week_tm.tm_yday + 7 - delta) / 7) + "-1"};
+        struct tm monday_tm{};
+        strptime(week_num.c_str(), "%Y-%W-%w", &monday_tm);
+        std::tm parsed {};
+        std::stringstream date_str(std::to_string((monday_tm.tm_year + 1900) * 10000 + (monday_tm.tm_mon + 1) * 100 +
+                                                  monday_tm.tm_mday));
+        date_str >> std::get_time(&parsed, "%Y%m%d");
+        return static_cast<long long>(std::mktime(&parsed));
+    };
+
+    BENCHMARK("strptime/mktime") {
+        long long sum {0};
+        for (const int day : days) {
+            sum += libc_week_key(civil_date::to_yyyymmdd(day));
+        }
+        return sum;
+    };
+
+    BENCHMARK("civil_date") {
+        long long sum {0};
+        for (const int day : days) {
+            sum += civil_date::to_epoch_seconds(civil_date::week_start(day, civil_date::monday));
+        }
+        return sum;
+    };
+}
+
+TEST_CASE("Graph Time Buckets", "[.benchmark]") {
+    std::vector<DrinkFacts> all_drinks(100000);
+    for (std::size_t i = 0; i < all_drinks.size(); i++) {
+        all_drinks[i].day = civil_date::days_from_civil(2000, 1, 1) + static_cast<int>(i * 8000 / all_drinks.size());
+        all_drinks[i].abv = 5.0;
+        all_drinks[i].size = 12.0;
+    }
+
+    // Previous graph path: one map insert or lookup per drink, keyed on the week's Monday in epoch seconds
+    BENCHMARK("std::map by week key") {
+        std::map<int, double> date_std_drinks {};
+        for (const DrinkFacts &drink : all_drinks) {
+            const int date {static_cast<int>(civil_date::to_epoch_seconds(civil_date::week_start(drink.day,
+                                                                                                civil_date::monday)))};
+            date_std_drinks[date] += drink.standard_drinks(0.6);
+        }
+        return date_std_drinks.size();
+    };
+
+    BENCHMARK("Flat array by week id") {
+        return GraphingCalculations::bucket_std_drinks(all_drinks, 0.6, TimeGranularity::Week).std_drinks.size();
+    };
+
+    BENCHMARK("Flat array by day") {
+        return GraphingCalculations::bucket_std_drinks(all_drinks, 0.6, TimeGranularity::Day).std_drinks.size();
+    };
+}
+
+TEST_CASE("IBU Distribution", "[.benchmark]") {
+    std::vector<double> ibus(100000);
+    for (std::size_t i = 0; i < ibus.size(); i++) {
+        ibus[i] = static_cast<double>((i * 7919) % 1200) / 10;  // 1200 distinct values up to 120 IBU
+    }
+
+    BENCHMARK("count_values_in_vect") {
+        return GraphingCalculations::count_values_in_vect(ibus).size();
+    };
+
+    BENCHMARK("Fixed width histogram") {
+        return Histograms::fixed_width(ibus, 5.0).total;
+    };
+
+    BENCHMARK("Decile histogram") {
+        return Histograms::quantiles(ibus, 10).total;
+    };
+}
+
+TEST_CASE("Consumption Plot Level of Detail", "[.benchmark]") {
+    // A day per point, for far longer than anyone logs, to make per-pixel overdraw obvious
+    std::vector<double> keys(1000000);
+    std::vector<double> values(keys.size());
+    for (std::size_t i = 0; i < keys.size(); i++) {
+        keys[i] = static_cast<double>(civil_date::to_epoch_seconds(static_cast<int>(i)));
+        values[i] = static_cast<double>(i % 11) / 2;
+    }
+    const LodPyramid pyramid(keys, values);
+
+    BENCHMARK("Build pyramid") {
+        return LodPyramid(keys, values).levels();
+    };
+
+    BENCHMARK("Full range at 500 px") {
+        return pyramid.visible(keys.front(), keys.back(), 500).size();
+    };
+
+    BENCHMARK("One year at 500 px") {
+        return pyramid.visible(keys[500000], keys[500365], 500).size();
+    };
+}
@@ -3,6 +3,13 @@
 //
 
 #include "../src/calculate.h"
+#include "../src/settings_snapshot.h"
+#include "../src/stats_engine.h"
+#include "../src/utilities.h"
+#include "test_helpers.h"
+#include <cmath>
+#include <cstdio>
+#include <ctime>
 #include <filesystem>
 #include <iostream>
 #if __has_include("catch2/catch_test_macros.hpp")
@@ -51,6 +58,33 @@ TEST_CASE("Oz Alcohol", "[Drink Calculations]") {
     REQUIRE(Calculate::equal_double(old_rasputin.get_alcohol_volume(), 1.08));
 }
 
+TEST_CASE("Settings Snapshot", "[Drink Calculations]") {
+    const auto previous_settings = SettingsSnapshot::current();
+    SettingsSnapshot::publish(Options {});  // United States, whatever the options file on this machine says
+    const auto original_settings = SettingsSnapshot::current();
+
+    Drink mosaic;
+    mosaic.set_abv(8.6);
+    mosaic.set_size(12);
+
+    Options custom_options {original_settings->options};
+    custom_options.std_drink_country = "Custom";
+    custom_options.std_drink_size = "0.5";
+    SettingsSnapshot::publish(custom_options);
+
+    REQUIRE(Calculate::equal_double(SettingsSnapshot::current()->std_drink_size, 0.5));
+    REQUIRE(Calculate::equal_double(mosaic.get_standard_drinks(), 2.06));
+    REQUIRE(Calculate::equal_double(mosaic.get_standard_drinks(0.6), 1.72));
+
+    // Readers holding the old snapshot are unaffected by the swap
+    REQUIRE(Calculate::equal_double(original_settings->std_drink_size, 0.6));
+
+    SettingsSnapshot::publish(original_settings->options);
+    REQUIRE(Calculate::equal_double(mosaic.get_standard_drinks(), 1.72));
+
+    SettingsSnapshot::publish(previous_settings->options);
+}
+
 TEST_CASE("Std Drinks Remaining - male, NIAAA", "[Drink Calculations]") {
     Options options;
     options.sex = "male";
@@ -482,4 +516,193 @@ TEST_CASE("String Comparison", "[Misc Calculations]") {
     std::string lhs = "WWW";
     std::string rhs = "aaa";
     REQUIRE(Calculate::compare_strings(lhs, rhs) == false);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Day Number", "[Misc Calculations]") {
+    Drink mosaic;
+    mosaic.set_date("2020-09-08");
+    REQUIRE(mosaic.get_day() == 18513);
+    mosaic.set_date("1970-01-01");
+    REQUIRE(mosaic.get_day() == 0);
+    mosaic.set_date("2020-03-01");
+    REQUIRE(mosaic.get_day() - civil_date::from_iso("2020-02-28") == 2);  // Leap year
+    REQUIRE(civil_date::from_iso("not a date") == 0);
+}
+
+TEST_CASE("Stats Snapshot", "[Drink Calculations]") {
+    std::string current_path = std::filesystem::current_path();
+    const char *file_name = "testdb.db";
+    std::string db_path = current_path + "/" + file_name;
+
+    if (remove(db_path.c_str())) {
+        std::cout << "Removed existing testdb.sqlite file" << std::endl;
+    }
+
+    Storage storage_1 = initStorage(db_path);
+    Database::increment_version(storage_1, Database::db_version);  // Streaks read daily_totals
+
+    const std::string today {utilities::get_local_date()};
+    const auto iso_date = [](const int day) {
+        const int yyyymmdd {civil_date::to_yyyymmdd(day)};
+        char date[11];
+        std::snprintf(date, sizeof(date), "%04d-%02d-%02d", yyyymmdd / 10000, yyyymmdd / 100 % 100, yyyymmdd % 100);
+        return std::string(date);
+    };
+    const int today_day {civil_date::from_iso(today)};
+
+    // Today, yesterday and the day before, then a gap
+    const std::vector<std::tuple<int, std::string, std::string, std::string, double, double>> rows {
+            {today_day, "Mosaic", "IPA", "Community Brewing", 8.4, 75.0},
+            {today_day - 1, "Everything Rhymes with Orange", "IPA", "Roughtail Brewing", 8.0, 60.0},
+            {today_day - 2, "Everything Rhymes with Orange", "IPA", "Roughtail Brewing", 8.0, -1.0},
+            {today_day - 5, "Tart", "Sour", "Community Brewing", 5.0, 10.0},
+    };
+    for (const auto &[day, name, type, producer, abv, ibu] : rows) {
+        Drink drink {make_test_drink(iso_date(day), name, producer, abv, ibu)};
+        drink.set_type(type);
+        storage_1.insert(drink);
+    }
+    Drink whiskey {Database::read_row(1, storage_1)};
+    whiskey.set_id(-1);
+    whiskey.set_name("Rye");
+    whiskey.set_alcohol_type("Liquor");
+    storage_1.insert(whiskey);
+
+    const StatsSnapshot stats {StatsEngine::compute(storage_1, "Beer", iso_date(today_day - 2), today, 0.6)};
+
+    REQUIRE(stats.rows_scanned == 5);
+    REQUIRE(stats.favorite_producer == Calculate::favorite_producer(storage_1, "Beer"));
+    REQUIRE(stats.favorite_drink == Calculate::favorite_drink(storage_1, "Beer"));
+    REQUIRE(stats.favorite_type == Calculate::favorite_type(storage_1, "Beer"));
+    REQUIRE(Calculate::equal_double(stats.mean_abv, Calculate::mean_abv(storage_1, "Beer")));
+    REQUIRE(std::fabs(stats.mean_ibu - Calculate::mean_ibu(storage_1, "Beer")) < 1e-9);
+    REQUIRE(std::fabs(stats.mean_ibu - (145.0 / 3)) < 1e-9);  // Empty IBU values are ignored
+    REQUIRE(stats.streaks.current == Calculate::days_in_row(storage_1));
+    REQUIRE(stats.streaks.current == 3);
+    REQUIRE(stats.streaks.longest == 3);
+    REQUIRE(stats.streaks.current_dry == 0);
+    REQUIRE(stats.streaks.longest_dry == 2);
+    REQUIRE(std::fabs(stats.std_drinks_today - (1.68 + 1.68)) < 1e-9);  // Mosaic and the rye
+    REQUIRE(std::fabs(stats.std_drinks_this_week - (1.68 * 2 + 1.6 * 2)) < 1e-9);
+    REQUIRE(std::fabs(stats.alcohol_volume_this_week - (0.084 * 12 * 2 + 0.08 * 12 * 2)) < 1e-9);
+
+    const StatsSnapshot empty {StatsEngine::compute(storage_1, "Wine", today, today, 0.6)};
+    REQUIRE(empty.favorite_drink.empty());
+    REQUIRE(std::isnan(empty.mean_abv));
+    REQUIRE(std::isnan(empty.mean_ibu));
+}
+
+TEST_CASE("Top K", "[Favorite Calculations]") {
+    std::string current_path = std::filesystem::current_path();
+    const char *file_name = "testdb.db";
+    std::string db_path = current_path + "/" + file_name;
+
+    if (remove(db_path.c_str())) {
+        std::cout << "Removed existing testdb.sqlite file" << std::endl;
+    }
+
+    Storage storage_1 = initStorage(db_path);
+    Database::write_db_to_disk(storage_1);
+
+    // Roughtail 3, then a tie between Community and Bell's at 2, then Ale Asylum 1
+    for (const std::string producer : {"Roughtail Brewing", "Community Brewing", "Roughtail Brewing", "Bell's",
+                                       "Community Brewing", "Roughtail Brewing", "Bell's", "Ale Asylum"}) {
+        storage_1.insert(make_test_drink("2020-09-08", "Mosaic", producer));
+    }
+
+    const std::vector<ValueCount> top {Calculate::top_k(storage_1, DrinkColumn::Producer, "Beer", 3)};
+    REQUIRE(top.size() == 3);
+    REQUIRE(top[0].value == "Roughtail Brewing");
+    REQUIRE(top[0].count == 3);
+    REQUIRE(top[1].value == "Bell's");
+    REQUIRE(top[2].value == "Community Brewing");
+    REQUIRE(top[2].count == 2);
+    REQUIRE(Calculate::top_k(storage_1, DrinkColumn::Producer, "Wine", 3).empty());
+
+    // Counts held in memory rank the same way
+    const std::unordered_map<std::string, int> counts {{"Roughtail Brewing", 3}, {"Community Brewing", 2},
+                                                       {"Bell's", 2}, {"Prairie", 1}};
+    const std::vector<ValueCount> top_counted {Calculate::top_k(counts, 3)};
+    REQUIRE(top_counted.size() == 3);
+    for (std::size_t i = 0; i < top_counted.size(); i++) {
+        REQUIRE(top_counted[i].value == top[i].value);
+        REQUIRE(top_counted[i].count == top[i].count);
+    }
+    REQUIRE(Calculate::top_k(counts, 0).empty());
+    REQUIRE(Calculate::top_k(counts, 10).size() == 4);
+
+    const StatsSnapshot stats {StatsEngine::compute(storage_1, "Beer", "2020-09-07", "2020-09-08", 0.6)};
+    const std::vector<ValueCount> top_five {Calculate::top_k(storage_1, DrinkColumn::Producer, "Beer", 5)};
+    REQUIRE(stats.top_producers.size() == top_five.size());
+    for (std::size_t i = 0; i < top_five.size(); i++) {
+        REQUIRE(stats.top_producers[i].value == top_five[i].value);
+        REQUIRE(stats.top_producers[i].count == top_five[i].count);
+    }
+}
+
+TEST_CASE("Streaks", "[Misc Calculations]") {
+    // Days 10-12, dry 13-16, 17-18, then today is 20
+    const std::vector<int> days {10, 11, 12, 17, 18};
+    Streaks streaks {Calculate::streaks(days, 20)};
+    REQUIRE(streaks.current == 0);
+    REQUIRE(streaks.longest == 3);
+    REQUIRE(streaks.current_dry == 2);
+    REQUIRE(streaks.longest_dry == 4);
+
+    // No drinks yet today still continues yesterday's streak
+    streaks = Calculate::streaks(days, 19);
+    REQUIRE(streaks.current == 2);
+    REQUIRE(streaks.current_dry == 1);
+
+    streaks = Calculate::streaks({10, 11, 12, 17, 18, 19, 25}, 19);  // Future days are ignored
+    REQUIRE(streaks.current == 3);
+    REQUIRE(streaks.longest == 3);
+    REQUIRE(streaks.current_dry == 0);
+
+    streaks = Calculate::streaks({}, 19);
+    REQUIRE(streaks.current == 0);
+    REQUIRE(streaks.longest_dry == 0);
+}
+
+TEST_CASE("Civil Date", "[Misc Calculations]") {
+    // Compare against the C library, in UTC, for every day from 1900 to 2100
+    std::string first_mismatch;
+    for (int day = civil_date::days_from_civil(1900, 1, 1); day <= civil_date::days_from_civil(2100, 12, 31); day++) {
+        const std::time_t seconds {static_cast<std::time_t>(civil_date::to_epoch_seconds(day))};
+        const std::tm *utc {std::gmtime(&seconds)};
+        char expected[32];
+        std::strftime(expected, sizeof(expected), "%Y-%m-%d %w %j %W %G %V", utc);
+
+        const IsoWeek iso_week {civil_date::iso_week(day)};
+        char actual[32];
+        std::snprintf(actual, sizeof(actual), "%s %u %03d %02d %d %02u", civil_date::to_iso(day).c_str(),
+                      civil_date::weekday(day), civil_date::day_of_year(day) + 1, civil_date::monday_week_number(day),
+                      iso_week.year, iso_week.week);
+        const bool round_trips {civil_date::from_iso(civil_date::to_iso(day)) == day &&
+                                civil_date::from_yyyymmdd(civil_date::to_yyyymmdd(day)) == day};
+        if (first_mismatch.empty() && (std::string(actual) != expected || !round_trips)) {
+            first_mismatch = std::string(actual) + " vs " + expected;
+        }
+    }
+    REQUIRE(first_mismatch.empty());
+
+    // Week starts for each Options::weekday_start, from Thursday 2020-09-10
+    const int thursday {civil_date::from_iso("2020-09-10")};
+    REQUIRE(civil_date::to_iso(civil_date::week_start(thursday, civil_date::weekday_from_name("Sunday"))) == "2020-09-06");
+    REQUIRE(civil_date::to_iso(civil_date::week_start(thursday, civil_date::weekday_from_name("Monday"))) == "2020-09-07");
+    REQUIRE(civil_date::week_start(thursday, civil_date::weekday_from_name("Thursday")) == thursday);
+    REQUIRE(civil_date::to_iso(civil_date::week_start(thursday, civil_date::weekday_from_name("Friday"))) == "2020-09-04");
+    REQUIRE(civil_date::weekday_from_name("Not a day") == civil_date::sunday);
+    REQUIRE(civil_date::weekday_name(civil_date::weekday(thursday)) == "Thursday");
+
+    // The Monday of every %W week maps back to that week
+    for (int year = 1990; year <= 2030; year++) {
+        for (int week = 0; week <= 53; week++) {
+            const int monday {civil_date::from_monday_week(year, week)};
+            REQUIRE(civil_date::iso_weekday(monday) == 1);
+            if (civil_date::civil_from_days(monday).year == year) {
+                REQUIRE(civil_date::monday_week_number(monday) == week);
+            }
+        }
+    }
+}
@@ -4,6 +4,14 @@
 
 #include "../src/database.h"
 #include "../src/calculate.h"
+#include "../src/drink_repository.h"
+#include "../src/drink_query.h"
+#include "../src/drink_columns.h"
+#include "../src/filter_dictionary.h"
+#include "../src/refresh_coordinator.h"
+#include "../src/stats_engine.h"
+#include "test_helpers.h"
+#include <cmath>
 #include <cstdio>
 #include <iostream>
 #include <sys/stat.h>
@@ -100,6 +108,186 @@ TEST_CASE("DB IO", "[DB Functions]") {
     REQUIRE(mosaic_read.get_type() == "IPA");
 }
 
+TEST_CASE("Drink Repository", "[DB Functions]") {
+    std::string current_path = std::filesystem::current_path();
+    const char *file_name = "testdb.db";
+    std::string db_path = current_path + "/" + file_name;
+
+    if (remove(db_path.c_str())) {
+        std::cout << "Removed existing testdb.sqlite file" << std::endl;
+    }
+
+    DrinkRepository repository(db_path);
+    Storage &storage_1 = repository.storage();
+    Database::write_db_to_disk(storage_1);
+
+    Drink etrwo {make_test_drink("2020-09-08", "Everything Rhymes with Orange", "Roughtail Brewing", 8.0, 60.0)};
+    etrwo.set_notes("Very good hazy IPA.");
+
+    const int inserted_id = Database::write(etrwo, storage_1);
+
+    REQUIRE(repository.path() == db_path);
+    REQUIRE(storage_1.is_opened());
+    REQUIRE(inserted_id == 1);
+    REQUIRE(Database::read_row(inserted_id, repository.storage()).get_name() == "Everything Rhymes with Orange");
+    REQUIRE(Database::filter("Alcohol Type", "Beer", repository.storage()).size() == 1);
+
+    // Reads on the connection are counted, writes and the triggers they fire aren't
+    const unsigned long long reads_before {repository.reads()};
+    Database::read_row(inserted_id, repository.storage());
+    REQUIRE(repository.reads() == reads_before + 1);
+    REQUIRE(DrinkQuery().alcohol_type("Beer").count(repository.storage()) == 1);
+    REQUIRE(repository.reads() == reads_before + 2);
+    Database::write(etrwo, storage_1);
+    REQUIRE(repository.reads() == reads_before + 2);
+}
+
+TEST_CASE("Aggregate Store", "[DB Functions]") {
+    std::string current_path = std::filesystem::current_path();
+    const char *file_name = "testdb.db";
+    std::string db_path = current_path + "/" + file_name;
+
+    if (remove(db_path.c_str())) {
+        std::cout << "Removed existing testdb.sqlite file" << std::endl;
+    }
+
+    DrinkRepository repository(db_path);
+    Storage &storage_1 = repository.storage();
+    Database::write_db_to_disk(storage_1);
+
+    // The totals kept by deltas must match a full scan after every write
+    const auto require_matches_full_scan = [&repository, &storage_1]() {
+        const StatsSnapshot incremental {repository.stats("Beer", "2020-09-06", "2020-09-10", 0.6)};
+        const StatsSnapshot full {StatsEngine::compute(storage_1, "Beer", "2020-09-06", "2020-09-10", 0.6)};
+        REQUIRE(repository.aggregates().size() == full.rows_scanned);
+        REQUIRE(std::fabs(incremental.std_drinks_this_week - full.std_drinks_this_week) < 1e-9);
+        REQUIRE(std::fabs(incremental.alcohol_volume_this_week - full.alcohol_volume_this_week) < 1e-9);
+        REQUIRE(std::fabs(incremental.std_drinks_today - full.std_drinks_today) < 1e-9);
+        REQUIRE(incremental.favorite_producer == full.favorite_producer);
+        REQUIRE(incremental.favorite_drink == full.favorite_drink);
+        REQUIRE(incremental.top_producers.size() == full.top_producers.size());
+        REQUIRE(incremental.streaks.current == full.streaks.current);
+        REQUIRE(incremental.streaks.longest == full.streaks.longest);
+        REQUIRE((std::isnan(full.mean_ibu) ? std::isnan(incremental.mean_ibu)
+                                           : std::fabs(incremental.mean_ibu - full.mean_ibu) < 1e-9));
+    };
+
+    repository.insert(make_test_drink("2020-09-08", "Mosaic", "Community Brewing", 8.4, 75.0));
+    require_matches_full_scan();  // First refresh builds the totals
+    REQUIRE(repository.aggregates().valid_for(0.6));
+
+    repository.insert(make_test_drink("2020-09-09", "Everything Rhymes with Orange", "Roughtail Brewing", 8.0, 60.0));
+    repository.insert(make_test_drink("2020-09-10", "Everything Rhymes with Orange", "Roughtail Brewing", 8.0, -1.0));
+    require_matches_full_scan();
+    REQUIRE(repository.stats("Beer", "2020-09-06", "2020-09-10", 0.6).streaks.current == 3);
+    REQUIRE(repository.stats("Beer", "2020-09-06", "2020-09-10", 0.6).favorite_producer == "Roughtail Brewing");
+
+    Drink moved {make_test_drink("2020-09-01", "Mosaic", "Community Brewing", 8.4, 75.0)};
+    moved.set_id(2);
+    repository.update(moved);
+    require_matches_full_scan();
+    REQUIRE(repository.stats("Beer", "2020-09-06", "2020-09-10", 0.6).streaks.current == 1);
+
+    // Streaks are kept between refreshes, but follow a drink on a day that had none and a change of date
+    repository.insert(make_test_drink("2020-09-09", "Mosaic", "Community Brewing", 8.4, 75.0));
+    require_matches_full_scan();
+    REQUIRE(repository.stats("Beer", "2020-09-06", "2020-09-10", 0.6).streaks.current == 3);
+    REQUIRE(repository.stats("Beer", "2020-09-06", "2020-09-12", 0.6).streaks.current == 0);
+    REQUIRE(repository.stats("Beer", "2020-09-06", "2020-09-12", 0.6).streaks.current_dry == 2);
+    REQUIRE(repository.remove(4));
+    require_matches_full_scan();
+    REQUIRE(repository.stats("Beer", "2020-09-06", "2020-09-10", 0.6).streaks.current == 1);
+
+    REQUIRE(repository.remove(1));
+    REQUIRE(repository.remove(3));
+    require_matches_full_scan();
+    REQUIRE(repository.aggregates().size() == 1);
+
+    // Rows deleted on another connection are skipped, leaving the totals alone
+    REQUIRE(!repository.remove(3));
+    Drink missing {make_test_drink("2020-09-10", "Mosaic", "Community Brewing", 8.4, 75.0)};
+    missing.set_id(3);
+    REQUIRE(!repository.update(missing));
+    require_matches_full_scan();
+    REQUIRE(repository.aggregates().size() == 1);
+
+    // A new standard drink size needs a rebuild
+    REQUIRE(!repository.aggregates().valid_for(0.5));
+    repository.aggregates().invalidate();
+    REQUIRE(!repository.aggregates().valid_for(0.6));
+    require_matches_full_scan();
+}
+
+TEST_CASE("Filter Dictionary", "[DB Functions]") {
+    std::string current_path = std::filesystem::current_path();
+    const char *file_name = "testdb.db";
+    std::string db_path = current_path + "/" + file_name;
+
+    if (remove(db_path.c_str())) {
+        std::cout << "Removed existing testdb.sqlite file" << std::endl;
+    }
+
+    DrinkRepository repository(db_path);
+    Storage &storage_1 = repository.storage();
+    Database::write_db_to_disk(storage_1);
+
+    const auto make_drink = [](const std::string &name, const std::string &producer, const std::string &subtype,
+                               const int rating) {
+        Drink drink {make_test_drink("2020-09-08", name, producer, 8.0, 60.0)};
+        drink.set_subtype(subtype);
+        drink.set_rating(rating);
+        return drink;
+    };
+    const std::vector<DrinkColumn> filter_columns {DrinkColumn::Name, DrinkColumn::Type, DrinkColumn::Subtype,
+                                                   DrinkColumn::Producer, DrinkColumn::Rating};
+    // The values kept by deltas must match a fresh read after every write
+    const auto require_matches_fresh_read = [&]() {
+        for (const DrinkColumn column : filter_columns) {
+            REQUIRE(repository.filters().values(storage_1, column) == FilterDictionary().values(storage_1, column));
+        }
+    };
+
+    repository.insert(make_drink("Mosaic", "Community Brewing", "", 8));
+    repository.insert(make_drink("Mosaic", "Community Brewing", "", 9));
+    REQUIRE(!repository.filters().loaded(DrinkColumn::Producer));
+    REQUIRE(repository.filters().values(storage_1, DrinkColumn::Name) == std::vector<std::string>{"Mosaic"});
+    REQUIRE(repository.filters().values(storage_1, DrinkColumn::Subtype).empty());
+    REQUIRE(repository.filters().values(storage_1, DrinkColumn::Rating) == std::vector<std::string>{"9", "8"});
+    require_matches_fresh_read();
+
+    // Loaded columns are answered without reading the database
+    const unsigned long long reads_before {repository.reads()};
+    repository.filters().values(storage_1, DrinkColumn::Producer);
+    REQUIRE(repository.reads() == reads_before);
+
+    // A name made by two producers is offered once per producer
+    repository.insert(make_drink("Mosaic", "Founders", "Single Hop", 10));
+    repository.insert(make_drink("Orange", "Roughtail Brewing", "", 7));
+    REQUIRE(repository.filters().values(storage_1, DrinkColumn::Name) ==
+            std::vector<std::string>{"Mosaic -- (Community Brewing)", "Mosaic -- (Founders)", "Orange"});
+    REQUIRE(repository.filters().values(storage_1, DrinkColumn::Rating) ==
+            std::vector<std::string>{"10", "9", "8", "7"});
+    require_matches_fresh_read();
+
+    Drink renamed {make_drink("Mosaic", "Community Brewing", "Single Hop", 10)};
+    renamed.set_id(3);
+    repository.update(renamed);
+    REQUIRE(repository.filters().values(storage_1, DrinkColumn::Name) == std::vector<std::string>{"Mosaic", "Orange"});
+    REQUIRE(repository.filters().values(storage_1, DrinkColumn::Producer) ==
+            std::vector<std::string>{"Community Brewing", "Roughtail Brewing"});
+    require_matches_fresh_read();
+
+    repository.remove(4);
+    REQUIRE(repository.filters().values(storage_1, DrinkColumn::Name) == std::vector<std::string>{"Mosaic"});
+    require_matches_fresh_read();
+
+    // Writes made around the repository need an invalidate
+    Database::write(make_drink("Orange", "Roughtail Brewing", "", 7), storage_1);
+    repository.filters().invalidate();
+    REQUIRE(!repository.filters().loaded(DrinkColumn::Name));
+    require_matches_fresh_read();
+}
+
 TEST_CASE("Truncate DB", "[DB Functions]") {
     std::string current_path = std::filesystem::current_path();
     const char *file_name = "testdb.db";
@@ -331,6 +519,43 @@ TEST_CASE("Write Row", "[DB Functions]") {
     REQUIRE(drinks_in_db.at(0).get_alcohol_type() == "Beer");
 }
 
+TEST_CASE("Batched Writer", "[DB Functions]") {
+    std::string current_path = std::filesystem::current_path();
+    const char *file_name = "testdb.db";
+    std::string db_path = current_path + "/" + file_name;
+
+    if (remove(db_path.c_str())) {
+        std::cout << "Removed existing testdb.sqlite file" << std::endl;
+    }
+
+    DrinkRepository repository(db_path);
+    Storage &storage_1 = repository.storage();
+    Database::write_db_to_disk(storage_1);
+
+    Drink mosaic {make_test_drink("2020-09-08", "Mosaic", "Community Brewing")};
+
+    {
+        DrinkWriter writer(storage_1, 2, Durability::Off);
+        REQUIRE(writer.insert(mosaic) == 1);
+        REQUIRE(writer.pending() == 1);
+        REQUIRE(writer.insert(mosaic) == 2);
+        REQUIRE(writer.pending() == 0);  // Batch of two committed
+        REQUIRE(writer.insert(mosaic) == 3);
+        REQUIRE(writer.pending() == 1);
+    }  // Destructor commits the partial batch
+
+    Storage storage_2 = initStorage(db_path);
+    REQUIRE(Database::read(storage_2).size() == 3);
+
+    // The repository's writer commits every write by default
+    mosaic.set_id(2);
+    mosaic.set_notes("Updated through the prepared statement.");
+    repository.writer().update(mosaic);
+    REQUIRE(repository.writer().pending() == 0);
+    REQUIRE(Database::read_row(2, storage_2).get_notes() == "Updated through the prepared statement.");
+    REQUIRE(repository.writer().insert(mosaic) == 4);
+}
+
 TEST_CASE("Update Row", "[DB Functions]") {
     std::string current_path = std::filesystem::current_path();
     const char *file_name = "testdb.db";
@@ -425,6 +650,187 @@ TEST_CASE("Increment Version", "[DB Functions]") {
     REQUIRE(base_version == 8);
 }
 
+TEST_CASE("Index Migration", "[DB Functions]") {
+    std::string current_path = std::filesystem::current_path();
+    const char *file_name = "testdb.db";
+    std::string db_path = current_path + "/" + file_name;
+
+    if (remove(db_path.c_str())) {
+        std::cout << "Removed existing testdb.sqlite file" << std::endl;
+    }
+
+    Storage storage_1 = initStorage(db_path);
+    REQUIRE(Database::increment_version(storage_1, Database::db_version) == Database::db_version);
+
+    // Ask SQLite how it would run the lookups in database.cpp and calculate.cpp
+    const auto query_plan = [&db_path](const std::string &query) {
+        sqlite3 *db {nullptr};
+        sqlite3_stmt *stmt {nullptr};
+        std::string plan;
+        sqlite3_open(db_path.c_str(), &db);
+        sqlite3_prepare_v2(db, ("EXPLAIN QUERY PLAN " + query).c_str(), -1, &stmt, nullptr);
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            plan += reinterpret_cast<const char *>(sqlite3_column_text(stmt, 3));
+        }
+        sqlite3_finalize(stmt);
+        sqlite3_close(db);
+        return plan;
+    };
+
+    REQUIRE(query_plan("SELECT * FROM drinks WHERE day = 18513").find("idx_drinks_day_id") != std::string::npos);
+    REQUIRE(query_plan("SELECT * FROM drinks ORDER BY day, id").find("idx_drinks_day_id") != std::string::npos);
+    REQUIRE(query_plan("SELECT * FROM drinks WHERE drink_name = 'Mosaic' AND alcohol_type = 'Beer'")
+            .find("idx_drinks_alcohol_type_name_producer") != std::string::npos);
+    REQUIRE(query_plan("SELECT * FROM drinks WHERE producer = 'Community Brewing'")
+            .find("idx_drinks_producer") != std::string::npos);
+    REQUIRE(query_plan("SELECT * FROM drinks WHERE drink_type = 'IPA'").find("idx_drinks_type") != std::string::npos);
+    REQUIRE(query_plan("SELECT * FROM drinks WHERE drink_subtype = 'Hazy IPA'")
+            .find("idx_drinks_subtype") != std::string::npos);
+
+    // ANALYZE ran as part of the migration
+    REQUIRE_NOTHROW(Database::execute(storage_1, "SELECT * FROM sqlite_stat1"));
+    REQUIRE_THROWS(Database::execute(storage_1, "SELECT * FROM no_such_table"));
+    REQUIRE_THROWS(Database::execute(storage_1, "DROP INDEX idx_drinks_date"));  // Replaced by idx_drinks_day_id
+}
+
+TEST_CASE("Day Column Migration", "[DB Functions]") {
+    std::string current_path = std::filesystem::current_path();
+    const char *file_name = "testdb.db";
+    std::string db_path = current_path + "/" + file_name;
+
+    if (remove(db_path.c_str())) {
+        std::cout << "Removed existing testdb.sqlite file" << std::endl;
+    }
+
+    // A version 8 database: text dates only, no day column or indexes
+    sqlite3 *old_db {nullptr};
+    sqlite3_open(db_path.c_str(), &old_db);
+    sqlite3_exec(old_db, "CREATE TABLE drinks (id INTEGER PRIMARY KEY AUTOINCREMENT NOT NULL, "
+                         "date TEXT DEFAULT '2020-01-01' NOT NULL, drink_name TEXT NOT NULL, drink_type TEXT NOT NULL, "
+                         "drink_subtype TEXT DEFAULT '' NOT NULL, producer TEXT DEFAULT '' NOT NULL, abv REAL NOT NULL, "
+                         "ibu REAL NOT NULL, _size REAL DEFAULT 0.0 NOT NULL, size REAL DEFAULT 0.0 NOT NULL, "
+                         "rating INTEGER NOT NULL, notes TEXT NOT NULL, vintage INTEGER DEFAULT -999 NOT NULL, "
+                         "alcohol_type TEXT DEFAULT 'Beer' NOT NULL, "
+                         "timestamp TEXT DEFAULT (DATETIME('now', 'localtime')) NOT NULL);"
+                         "INSERT INTO drinks (date, drink_name, drink_type, abv, ibu, rating, notes) VALUES "
+                         "('2020-09-08', 'Mosaic', 'IPA', 8.4, 75, 8, ''), ('1969-12-31', 'Mosaic', 'IPA', 8.4, 75, 8, '');"
+                         "CREATE INDEX idx_drinks_date ON drinks (date);"
+                         "PRAGMA user_version = 8;", nullptr, nullptr, nullptr);
+    sqlite3_close(old_db);
+
+    Storage storage_1 = initStorage(db_path);
+    REQUIRE(Database::increment_version(storage_1, Database::db_version) == Database::db_version);
+    REQUIRE(Database::read_row(1, storage_1).get_day() == 18513);
+    REQUIRE(Database::read_row(2, storage_1).get_day() == -1);
+    REQUIRE(Database::read(storage_1).at(0).get_id() == 2);
+
+    // Version 11 fills daily_totals after the day column is set
+    const std::vector<DailyTotal> totals {Database::daily_totals(storage_1, -10, 20000)};
+    REQUIRE(totals.size() == 2);
+    REQUIRE(totals.at(0).day == -1);
+    REQUIRE(totals.at(1).day == 18513);
+    REQUIRE(totals.at(1).drinks == 1);
+}
+
+TEST_CASE("Failed Migration", "[DB Functions]") {
+    std::string current_path = std::filesystem::current_path();
+    const char *file_name = "testdb.db";
+    std::string db_path = current_path + "/" + file_name;
+
+    if (remove(db_path.c_str())) {
+        std::cout << "Removed existing testdb.sqlite file" << std::endl;
+    }
+
+    // A version 8 database whose day fill is made to fail
+    sqlite3 *old_db {nullptr};
+    sqlite3_open(db_path.c_str(), &old_db);
+    sqlite3_exec(old_db, "CREATE TABLE drinks (id INTEGER PRIMARY KEY AUTOINCREMENT NOT NULL, "
+                         "date TEXT DEFAULT '2020-01-01' NOT NULL, drink_name TEXT NOT NULL, drink_type TEXT NOT NULL, "
+                         "drink_subtype TEXT DEFAULT '' NOT NULL, producer TEXT DEFAULT '' NOT NULL, abv REAL NOT NULL, "
+                         "ibu REAL NOT NULL, _size REAL DEFAULT 0.0 NOT NULL, size REAL DEFAULT 0.0 NOT NULL, "
+                         "rating INTEGER NOT NULL, notes TEXT NOT NULL, vintage INTEGER DEFAULT -999 NOT NULL, "
+                         "alcohol_type TEXT DEFAULT 'Beer' NOT NULL, "
+                         "timestamp TEXT DEFAULT (DATETIME('now', 'localtime')) NOT NULL);"
+                         "INSERT INTO drinks (date, drink_name, drink_type, abv, ibu, rating, notes) VALUES "
+                         "('2020-09-08', 'Mosaic', 'IPA', 8.4, 75, 8, '');"
+                         "CREATE TRIGGER fail_migration BEFORE UPDATE ON drinks BEGIN SELECT RAISE(ABORT, 'boom'); END;"
+                         "PRAGMA user_version = 8;", nullptr, nullptr, nullptr);
+    sqlite3_close(old_db);
+
+    Storage storage_1 = initStorage(db_path);
+    REQUIRE_THROWS(Database::increment_version(storage_1, Database::db_version));
+    REQUIRE(Database::get_version(storage_1) == 8);
+    REQUIRE(Database::read_row(1, storage_1).get_day() == 0);
+
+    // The next start runs the migration again
+    Database::execute(storage_1, "DROP TRIGGER fail_migration");
+    REQUIRE(Database::increment_version(storage_1, Database::db_version) == Database::db_version);
+    REQUIRE(Database::read_row(1, storage_1).get_day() == 18513);
+    REQUIRE(Database::daily_totals(storage_1, 18513, 18513).size() == 1);
+}
+
+TEST_CASE("Daily Totals", "[DB Functions]") {
+    std::string current_path = std::filesystem::current_path();
+    const char *file_name = "testdb.db";
+    std::string db_path = current_path + "/" + file_name;
+
+    if (remove(db_path.c_str())) {
+        std::cout << "Removed existing testdb.sqlite file" << std::endl;
+    }
+
+    DrinkRepository repository(db_path);
+    Storage &storage_1 = repository.storage();
+    Database::increment_version(storage_1, Database::db_version);  // Creates daily_totals, as at startup
+
+    Drink mosaic {make_test_drink("2020-09-08", "Mosaic", "Community Brewing")};
+
+    Drink whiskey {mosaic};
+    whiskey.set_name("Rye");
+    whiskey.set_abv(50.0);
+    whiskey.set_size(2.0);
+    whiskey.set_alcohol_type("Liquor");
+
+    // Every write path goes through the triggers
+    Database::write(mosaic, storage_1);
+    repository.insert(mosaic);
+    repository.writer().insert(whiskey);
+    std::vector<DailyTotal> totals {Database::daily_totals(storage_1, 18513, 18513)};
+    REQUIRE(totals.size() == 2);
+    REQUIRE(totals.at(0).alcohol_type == "Beer");
+    REQUIRE(totals.at(0).drinks == 2);
+    REQUIRE(std::fabs(totals.at(0).alcohol_volume - 0.084 * 12 * 2) < 1e-9);
+    REQUIRE(totals.at(1).alcohol_type == "Liquor");
+    REQUIRE(std::fabs(totals.at(1).alcohol_volume - 1.0) < 1e-9);
+
+    // Moving a drink to another day moves its volume
+    Drink moved {mosaic};
+    moved.set_id(2);
+    moved.set_date("2020-09-09");
+    repository.update(moved);
+    totals = Database::daily_totals(storage_1, 18513, 18514);
+    REQUIRE(totals.size() == 3);
+    REQUIRE(totals.at(0).drinks == 1);
+    REQUIRE(totals.at(2).day == 18514);
+
+    // Days with no drinks left are removed
+    repository.remove(2);
+    REQUIRE(Database::daily_totals(storage_1, 18514, 18514).empty());
+    Database::truncate(storage_1);
+    REQUIRE(Database::daily_totals(storage_1, 0, 30000).empty());
+
+    // Rebuilding matches what the triggers maintained
+    Database::write(mosaic, storage_1);
+    Database::write(whiskey, storage_1);
+    const std::vector<DailyTotal> maintained {Database::daily_totals(storage_1, 0, 30000)};
+    Database::rebuild_daily_totals(storage_1);
+    const std::vector<DailyTotal> rebuilt {Database::daily_totals(storage_1, 0, 30000)};
+    REQUIRE(maintained.size() == rebuilt.size());
+    for (std::size_t i = 0; i < rebuilt.size(); i++) {
+        REQUIRE(maintained[i].drinks == rebuilt[i].drinks);
+        REQUIRE(std::fabs(maintained[i].alcohol_volume - rebuilt[i].alcohol_volume) < 1e-9);
+    }
+}
+
 TEST_CASE("Filter DB", "[DB Functions]") {
     std::string current_path = std::filesystem::current_path();
     const char *file_name = "testdb.db";
@@ -515,6 +921,127 @@ TEST_CASE("Filter DB", "[DB Functions]") {
     REQUIRE(filter_by_rating.at(0).get_name() == "Mosaic");
 }
 
+TEST_CASE("Drink Query", "[DB Functions]") {
+    std::string current_path = std::filesystem::current_path();
+    const char *file_name = "testdb.db";
+    std::string db_path = current_path + "/" + file_name;
+
+    if (remove(db_path.c_str())) {
+        std::cout << "Removed existing testdb.sqlite file" << std::endl;
+    }
+
+    Storage storage_1 = initStorage(db_path);
+    Database::write_db_to_disk(storage_1);
+
+    Drink mosaic {make_test_drink("2020-09-08", "Mosaic", "Community Brewing")};
+    mosaic.set_notes("Hoppy");
+
+    Drink cabernet {make_test_drink("2020-09-10", "Reserve", "Silver Oak", 14.5, -1, "Wine")};
+    cabernet.set_type("Red");
+    cabernet.set_subtype("Cabernet Sauvignon");
+    cabernet.set_size(5.0);
+    cabernet.set_rating(9);
+    cabernet.set_vintage(2016);
+
+    storage_1.insert(mosaic);   // 1
+    storage_1.insert(cabernet); // 2
+    mosaic.set_date("2020-09-12");
+    storage_1.insert(mosaic);   // 3
+    mosaic.set_date("2020-09-09");
+    mosaic.set_rating(6);
+    storage_1.insert(mosaic);   // 4
+
+    DrinkQuery beers_since;
+    beers_since.alcohol_type("Beer").on_or_after("2020-09-09").order_by_date(true);
+    REQUIRE(beers_since.sql() == "SELECT id, date, drink_name, drink_type, drink_subtype, producer, abv, ibu, _size, "
+                                 "rating, notes, vintage, alcohol_type, timestamp FROM drinks "
+                                 "WHERE alcohol_type = ? AND day >= ? ORDER BY day DESC, id DESC");
+    std::vector<Drink> beers {beers_since.run(storage_1)};
+    REQUIRE(beers.size() == 2);
+    REQUIRE(beers.at(0).get_id() == 3);
+    REQUIRE(beers.at(0).get_day() == civil_date::from_iso("2020-09-12"));
+    REQUIRE(beers.at(1).get_notes() == "Hoppy");
+    REQUIRE(beers.at(1).get_size() == 12.0);
+    REQUIRE(beers_since.count(storage_1) == 2);
+
+    // Projection and limit
+    std::vector<Drink> abvs {DrinkQuery().between_dates("2020-09-08", "2020-09-10").order_by(DrinkColumn::Abv, true)
+                                     .limit(2).columns({DrinkColumn::Abv, DrinkColumn::Name}).run(storage_1)};
+    REQUIRE(abvs.size() == 2);
+    REQUIRE(abvs.at(0).get_abv() == 14.5);
+    REQUIRE(abvs.at(0).get_name() == "Reserve");
+    REQUIRE(abvs.at(0).get_id() == 0);
+    REQUIRE(abvs.at(0).get_producer().empty());
+
+    // Keyset pages, newest first. Each page starts after the last drink of the one before.
+    DrinkQuery first_page_query;
+    first_page_query.order_by_date(true).limit(2);
+    const std::vector<Drink> first_page {first_page_query.run(storage_1)};
+    REQUIRE(first_page.size() == 2);
+    REQUIRE(first_page.at(0).get_id() == 3);
+    REQUIRE(first_page.at(1).get_id() == 2);
+    DrinkQuery next_page_query;
+    next_page_query.after(DrinkKey::of(first_page.back()), true).order_by_date(true).limit(2);
+    REQUIRE(next_page_query.sql() == "SELECT id, date, drink_name, drink_type, drink_subtype, producer, abv, ibu, "
+                                     "_size, rating, notes, vintage, alcohol_type, timestamp FROM drinks "
+                                     "WHERE (day, id) < (?, ?) ORDER BY day DESC, id DESC LIMIT 2");
+    const std::vector<Drink> next_page {next_page_query.run(storage_1)};
+    REQUIRE(next_page.size() == 2);
+    REQUIRE(next_page.at(0).get_id() == 4);
+    REQUIRE(next_page.at(1).get_id() == 1);
+    REQUIRE(DrinkQuery().after(DrinkKey::of(next_page.back()), true).count(storage_1) == 0);
+    REQUIRE(DrinkQuery().alcohol_type("Beer").after({civil_date::from_iso("2020-09-09"), 4}).count(storage_1) == 1);
+
+    REQUIRE(DrinkQuery().rating_between(7, 9).count(storage_1) == 3);
+    REQUIRE(DrinkQuery().where(DrinkColumn::Date, std::string("2020-09-10")).count(storage_1) == 1);
+    REQUIRE(DrinkQuery().where(DrinkColumn::Vintage, 2016).run(storage_1).at(0).get_name() == "Reserve");
+
+    // Distinct rows, as the entry dropdowns read them
+    DrinkQuery entry_values;
+    entry_values.columns({DrinkColumn::AlcoholType, DrinkColumn::Name, DrinkColumn::Producer}).distinct();
+    REQUIRE(entry_values.sql() == "SELECT DISTINCT alcohol_type, drink_name, producer FROM drinks");
+    REQUIRE(entry_values.run(storage_1).size() == 2);
+
+    // The main window's filter strings
+    REQUIRE(DrinkQuery::from_filter("Name & Producer", "Mosaic -- (Community Brewing)").count(storage_1) == 3);
+    REQUIRE(DrinkQuery::from_filter("Name & Producer", "Mosaic -- (Silver Oak)").count(storage_1) == 0);
+    REQUIRE(DrinkQuery::from_filter("Name & Producer", "Mosaic").count(storage_1) == 3);  // Only one producer
+    REQUIRE(DrinkQuery::from_filter("Name & Producer", "Pliny").count(storage_1) == 0);
+    REQUIRE(DrinkQuery::from_filter("Rating", "6").count(storage_1) == 1);
+    REQUIRE(DrinkQuery::from_filter("Subtype", "Cabernet Sauvignon").count(storage_1) == 1);
+    REQUIRE(DrinkQuery::from_filter("", "").count(storage_1) == 4);
+    REQUIRE(Database::filter("Alcohol Type", "Beer", storage_1).at(1).get_id() == 4);
+
+    // Facts carry only what stats and graphs need
+    std::vector<DrinkFacts> facts {DrinkQuery().on_or_after("2020-09-09").order_by_date().facts(storage_1)};
+    REQUIRE(facts.size() == 3);
+    REQUIRE(facts.at(0).day == civil_date::from_iso("2020-09-09"));
+    REQUIRE(facts.at(1).alcohol_type == "Wine");
+    REQUIRE(facts.at(1).abv == 14.5);
+    REQUIRE(facts.at(1).size == 5.0);
+    REQUIRE(facts.at(1).ibu == -1);
+    REQUIRE(facts.at(1).rating == 9);
+    REQUIRE(facts.at(2).standard_drinks(0.6) == 1.68);
+
+    // Streaming visits the same rows in the same order, one reused drink at a time
+    std::vector<int> streamed_ids;
+    Database::for_each(storage_1, [&streamed_ids](const Drink &drink) {
+        streamed_ids.push_back(drink.get_id());
+    });
+    REQUIRE(streamed_ids == std::vector<int>{1, 4, 2, 3});
+    std::vector<std::string> streamed_notes;
+    beers_since.for_each(storage_1, [&streamed_notes](const Drink &drink) {
+        streamed_notes.push_back(drink.get_notes());
+    });
+    REQUIRE(streamed_notes.size() == 2);
+    REQUIRE(streamed_notes.at(1) == "Hoppy");
+    double streamed_size {0.0};
+    DrinkQuery().on_or_after("2020-09-09").for_each_fact(storage_1, [&streamed_size](const DrinkFacts &fact) {
+        streamed_size += fact.size;
+    });
+    REQUIRE(streamed_size == Approx(facts.at(0).size + facts.at(1).size + facts.at(2).size));
+}
+
 TEST_CASE("Get Drink By Name", "[DB Functions]") {
     std::string current_path = std::filesystem::current_path();
     const char *file_name = "testdb.db";
@@ -846,4 +1373,116 @@ TEST_CASE("DB Sort", "[DB Functions]") {
     REQUIRE(drinks.at(1).get_name() == "Mosaic");
     REQUIRE(drinks.at(2).get_name() == "Mosaic");
     REQUIRE(drinks.at(3).get_name() == "Everything Rhymes with Orange");
-}
\ No newline at end of file
+}
+
+TEST_CASE("Drink Columns", "[DB Functions]") {
+    Drink mosaic {make_test_drink("2020-08-08", "Mosaic", "Community Brewing", 8.6, -1.0)};
+    mosaic.set_id(4);
+    mosaic.set_timestamp("2020-08-08 20:00:00");
+
+    Drink mosaic_again {mosaic};
+    mosaic_again.set_id(7);
+    mosaic_again.set_date("2020-09-08");
+    mosaic_again.set_timestamp("2020-09-08 20:00:00");
+    mosaic_again.set_sort_order(2);
+
+    DrinkColumns columns;
+    columns.assign({mosaic, mosaic_again});
+
+    REQUIRE(columns.size() == 2);
+    REQUIRE(columns.id(1) == 7);
+    REQUIRE(columns.day(0) == civil_date::from_iso("2020-08-08"));
+    REQUIRE(columns.name(1) == "Mosaic");
+    REQUIRE(columns.producer(0) == "Community Brewing");
+    REQUIRE(columns.ibu(0) == -1.0);
+    REQUIRE(columns.rating(1) == 8);
+    REQUIRE(columns.timestamp(1) == "2020-09-08 20:00:00");
+    REQUIRE(columns.date_order(0) < columns.date_order(1));
+    REQUIRE(Calculate::equal_double(columns.std_drinks(0, 0.6), mosaic.get_standard_drinks(0.6)));
+
+    // Repeated strings are stored once: "Mosaic", "IPA", "" and "Community Brewing"
+    REQUIRE(columns.distinct_strings() == 4);
+
+    // Single-row patches, found by ID
+    REQUIRE(columns.row_of(7) == 1);
+    REQUIRE(columns.row_of(5) == -1);
+    Drink hazy {mosaic};
+    hazy.set_id(5);
+    hazy.set_name("Hazy Mosaic");
+    columns.append(hazy);
+    REQUIRE(columns.row_of(5) == 2);
+    REQUIRE(columns.name(2) == "Hazy Mosaic");
+    hazy.set_rating(9);
+    columns.set(2, hazy);
+    REQUIRE(columns.rating(2) == 9);
+    columns.erase(0);
+    REQUIRE(columns.size() == 2);
+    REQUIRE(columns.row_of(4) == -1);
+    REQUIRE(columns.row_of(7) == 0);
+    REQUIRE(columns.row_of(5) == 1);
+
+    // Ordered by date, then by ID on the same day, like Database::sort_by_date_id
+    REQUIRE(columns.date_order(1) < columns.date_order(0));
+    hazy.set_date("2020-09-08");
+    columns.set(1, hazy);
+    REQUIRE(columns.date_order(1) < columns.date_order(0));
+    hazy.set_date("2020-09-09");
+    columns.set(1, hazy);
+    REQUIRE(columns.date_order(0) < columns.date_order(1));
+
+    columns.assign({mosaic});
+    REQUIRE(columns.size() == 1);
+    REQUIRE(columns.distinct_strings() == 5);
+
+    columns.clear();
+    REQUIRE(columns.size() == 0);
+    REQUIRE(columns.distinct_strings() == 0);
+}
+
+TEST_CASE("Refresh Coordinator", "[DB Functions]") {
+    int scheduled {0};
+    RefreshCoordinator refresh([&scheduled] { scheduled++; });
+
+    REQUIRE_FALSE(refresh.pending());
+    refresh.mark(0);
+    REQUIRE(scheduled == 0);
+
+    // Marks before the flush share one scheduled flush
+    refresh.begin_action("Submit", 10);
+    refresh.mark(RefreshCoordinator::Stats);
+    refresh.mark(RefreshCoordinator::EntryFields | RefreshCoordinator::Stats);
+    REQUIRE(scheduled == 1);
+    REQUIRE(refresh.pending());
+    REQUIRE(refresh.take() == (RefreshCoordinator::Stats | RefreshCoordinator::EntryFields));
+    REQUIRE_FALSE(refresh.pending());
+    REQUIRE(refresh.take() == 0);
+
+    const ActionReads submit {refresh.end_action(13)};
+    REQUIRE(submit.action == "Submit");
+    REQUIRE(submit.reads == 3);
+
+    // A mark after the flush schedules the next one
+    refresh.mark(RefreshCoordinator::Table);
+    REQUIRE(scheduled == 2);
+    REQUIRE(refresh.take() == RefreshCoordinator::Table);
+    REQUIRE(refresh.end_action(13).reads == 0);
+
+    // An action that marked nothing isn't reported with the next one
+    refresh.begin_action("Delete", 13);
+    refresh.begin_action("Submit", 20);
+    refresh.mark(RefreshCoordinator::Stats);
+    refresh.take();
+    const ActionReads after_delete {refresh.end_action(22)};
+    REQUIRE(after_delete.action == "Submit");
+    REQUIRE(after_delete.reads == 2);
+
+    // An action started while a flush is due shares it
+    refresh.begin_action("Submit", 22);
+    refresh.mark(RefreshCoordinator::Stats);
+    refresh.begin_action("Delete", 23);
+    refresh.mark(RefreshCoordinator::EntryFields);
+    REQUIRE(refresh.take() == (RefreshCoordinator::Stats | RefreshCoordinator::EntryFields));
+    const ActionReads shared {refresh.end_action(25)};
+    REQUIRE(shared.action == "Submit + Delete");
+    REQUIRE(shared.reads == 3);
+}
@@ -3,6 +3,11 @@
 //
 
 #include "src/graphing_calculations.h"
+#include "src/database.h"
+#include "src/civil_date.h"
+#include "src/histogram.h"
+#include "src/lod_pyramid.h"
+#include <algorithm>
 #include <map>
 #if __has_include("catch2/catch_test_macros.hpp")
 #include <catch2/catch_test_macros.hpp>
@@ -186,4 +191,236 @@ TEST_CASE("Count Values in Vector", "[Graph Data Compilation]") {
     std::map<double, size_t> output_values = GraphingCalculations::count_values_in_vect(input_values);
 
     REQUIRE(output_values == expected_values);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Drink Facts Vectors", "[Graph Data Compilation]") {
+    DrinkFacts mosaic;
+    mosaic.day = 18513;
+    mosaic.abv = 8.4;
+    mosaic.size = 12.0;
+    mosaic.ibu = 75.0;
+    mosaic.alcohol_type = "Beer";
+
+    DrinkFacts titos;
+    titos.day = 18738;
+    titos.abv = 40.0;
+    titos.size = 2.0;
+    titos.alcohol_type = "Liquor";
+
+    const std::vector<DrinkFacts> all_drinks {mosaic, titos};
+
+    REQUIRE(GraphingCalculations::get_beer_ibus(all_drinks) == std::vector<double>{75.0});
+    REQUIRE(GraphingCalculations::get_drink_abvs(all_drinks) == std::vector<double>{8.4, 40.0});
+    REQUIRE(titos.standard_drinks(0.6) == 1.33);
+}
+
+TEST_CASE("Time Buckets", "[Graph Data Compilation]") {
+    const auto facts = [](const int year, const unsigned month, const unsigned day) {
+        DrinkFacts drink;
+        drink.day = civil_date::days_from_civil(year, month, day);
+        drink.abv = 5.0;
+        drink.size = 12.0;  // 0.6 oz. alcohol, one US standard drink
+        drink.alcohol_type = "Beer";
+        return drink;
+    };
+
+    // Out of order, with a gap, across a year boundary
+    const std::vector<DrinkFacts> all_drinks {facts(2021, 1, 3), facts(2020, 12, 31), facts(2021, 1, 20),
+                                              facts(2021, 1, 20)};
+
+    SECTION("Weeks start on Monday and run across the new year") {
+        const TimeSeries series {GraphingCalculations::bucket_std_drinks(all_drinks, 0.6, TimeGranularity::Week)};
+        REQUIRE(GraphingCalculations::bucket_start_day(series.first_bucket, TimeGranularity::Week) ==
+                civil_date::days_from_civil(2020, 12, 28));
+        REQUIRE(series.std_drinks == std::vector<double>{2.0, 0.0, 0.0, 2.0});
+    }
+
+    SECTION("Weeks 52 and 53 are not skipped") {
+        // 2024 starts on a Monday, so %W numbers 2024-12-23 as week 52 and 2024-12-30 as week 53
+        const std::vector<DrinkFacts> new_year {facts(2024, 12, 16), facts(2025, 1, 6)};
+        const BucketRange range {GraphingCalculations::bucket_range(new_year, TimeGranularity::Week)};
+        REQUIRE(range.count == 4);
+        REQUIRE(civil_date::monday_week_number(GraphingCalculations::bucket_start_day(range.first_bucket + 2,
+                                                                                     TimeGranularity::Week)) == 53);
+
+        const TimeSeries series {GraphingCalculations::bucket_std_drinks(new_year, 0.6, TimeGranularity::Week)};
+        REQUIRE(series.std_drinks == std::vector<double>{1.0, 0.0, 0.0, 1.0});
+    }
+
+    SECTION("Days, months and years") {
+        const TimeSeries days {GraphingCalculations::bucket_std_drinks(all_drinks, 0.6, TimeGranularity::Day)};
+        REQUIRE(days.std_drinks.size() == 21);
+        REQUIRE(days.std_drinks.front() == 1.0);
+        REQUIRE(days.std_drinks.back() == 2.0);
+
+        const TimeSeries months {GraphingCalculations::bucket_std_drinks(all_drinks, 0.6, TimeGranularity::Month)};
+        REQUIRE(GraphingCalculations::bucket_start_day(months.first_bucket, TimeGranularity::Month) ==
+                civil_date::days_from_civil(2020, 12, 1));
+        REQUIRE(months.std_drinks == std::vector<double>{1.0, 3.0});
+
+        const TimeSeries years {GraphingCalculations::bucket_std_drinks(all_drinks, 0.6, TimeGranularity::Year)};
+        REQUIRE(years.first_bucket == 2020);
+        REQUIRE(years.std_drinks == std::vector<double>{1.0, 3.0});
+    }
+
+    SECTION("Daily totals sum like the drinks in them") {
+        // What the daily_totals triggers keep for all_drinks: oz of alcohol per day and alcohol type
+        const std::vector<DailyTotal> totals {{civil_date::days_from_civil(2020, 12, 31), "Beer", 0.6, 1},
+                                              {civil_date::days_from_civil(2021, 1, 3), "Beer", 0.6, 1},
+                                              {civil_date::days_from_civil(2021, 1, 20), "Beer", 1.2, 2}};
+        for (const TimeGranularity granularity : {TimeGranularity::Day, TimeGranularity::Week,
+                                                  TimeGranularity::Month, TimeGranularity::Year}) {
+            const TimeSeries from_totals {GraphingCalculations::bucket_daily_totals(totals, 0.6, granularity)};
+            const TimeSeries from_drinks {GraphingCalculations::bucket_std_drinks(all_drinks, 0.6, granularity)};
+            REQUIRE(from_totals.first_bucket == from_drinks.first_bucket);
+            REQUIRE(from_totals.std_drinks.size() == from_drinks.std_drinks.size());
+            for (std::size_t i {0}; i < from_totals.std_drinks.size(); i++) {
+                REQUIRE(from_totals.std_drinks[i] == Approx(from_drinks.std_drinks[i]));
+            }
+        }
+        REQUIRE(GraphingCalculations::bucket_daily_totals({}, 0.6, TimeGranularity::Week).std_drinks.empty());
+    }
+
+    SECTION("Bucket ids round trip") {
+        for (int day {civil_date::days_from_civil(1999, 12, 1)}; day < civil_date::days_from_civil(2001, 2, 1); day++) {
+            for (const TimeGranularity granularity : {TimeGranularity::Day, TimeGranularity::Week,
+                                                      TimeGranularity::Month, TimeGranularity::Year}) {
+                const int bucket {GraphingCalculations::bucket_id(day, granularity)};
+                const int start {GraphingCalculations::bucket_start_day(bucket, granularity)};
+                if (start > day || GraphingCalculations::bucket_id(start, granularity) != bucket ||
+                    GraphingCalculations::bucket_id(start - 1, granularity) != bucket - 1) {
+                    FAIL("Bucket " << bucket << " does not start on day " << start);
+                }
+            }
+        }
+    }
+
+    REQUIRE(GraphingCalculations::bucket_range({}, TimeGranularity::Week).count == 0);
+    REQUIRE(GraphingCalculations::bucket_std_drinks({}, 0.6, TimeGranularity::Week).std_drinks.empty());
+}
+
+TEST_CASE("Histograms", "[Graph Data Compilation]") {
+    const std::vector<double> values {4.8, 5.0, 5.5, 5.5, 6.0, 9.9, 10.0};
+
+    SECTION("Fixed width over a given range") {
+        const Histogram histogram {Histograms::fixed_width(values, 2.0, 4.0, 10.0)};
+        REQUIRE(histogram.bins.size() == 3);
+        REQUIRE(histogram.bins.at(0).count == 4);  // 4 <= value < 6
+        REQUIRE(histogram.bins.at(1).count == 1);
+        REQUIRE(histogram.bins.at(2).count == 2);  // The upper edge is in the last bin
+        REQUIRE(histogram.total == 7);
+        REQUIRE(histogram.out_of_range == 0);
+
+        const Histogram narrow {Histograms::fixed_width(values, 1.0, 5.0, 6.0)};
+        REQUIRE(narrow.total == 4);
+        REQUIRE(narrow.out_of_range == 3);
+    }
+
+    SECTION("Fixed width over the data's range") {
+        const Histogram histogram {Histograms::fixed_width(values, 1.0)};
+        REQUIRE(histogram.bins.front().lower == 4.0);
+        REQUIRE(histogram.bins.back().lower == 10.0);  // 10 gets its own bin rather than sharing 9's
+        REQUIRE(histogram.bins.back().count == 1);
+        REQUIRE(histogram.total == values.size());
+        REQUIRE(Histograms::fixed_width({}, 1.0).bins.empty());
+    }
+
+    SECTION("Fixed width with an outlier") {
+        const std::vector<double> sizes {12.0, 16.0, 16.0, 5000.0};  // 5000 oz. is a typo
+        const auto size_range {Histograms::plausible_range(HistogramMetric::Size)};
+        const Histogram limited {Histograms::fixed_width(sizes, 1.0, size_range)};
+        REQUIRE(limited.bins.size() == 5);  // 12 to 17
+        REQUIRE(limited.total == 3);
+        REQUIRE(limited.out_of_range == 1);
+        REQUIRE(Histograms::fixed_width({1000.0}, 1.0, size_range).bins.empty());
+
+        const Histogram capped {Histograms::fixed_width({0.0, 1e12}, 1.0)};
+        REQUIRE(capped.bins.size() == Histograms::max_bins);
+        REQUIRE(capped.total == 1);
+        REQUIRE(capped.out_of_range == 1);
+    }
+
+    SECTION("Quantiles") {
+        std::vector<double> hundred(100);
+        for (std::size_t i = 0; i < hundred.size(); i++) {
+            hundred[i] = static_cast<double>(99 - i);
+        }
+        const Histogram deciles {Histograms::quantiles(hundred, 10)};
+        REQUIRE(deciles.bins.size() == 10);
+        for (const HistogramBin &bin : deciles.bins) {
+            REQUIRE(bin.count == 10);
+        }
+        REQUIRE(deciles.bins.back().upper == 99.0);
+
+        // Ties aren't split across bins
+        const Histogram ties {Histograms::quantiles({1, 1, 1, 1, 1, 1, 1, 1, 2, 3}, 5)};
+        REQUIRE(ties.bins.size() == 2);
+        REQUIRE(ties.bins.at(0).count == 8);
+        REQUIRE(ties.bins.at(1).count == 2);
+        REQUIRE(Histograms::quantiles({7, 7}, 4).bins.size() == 1);
+        REQUIRE(Histograms::quantiles({}, 4).bins.empty());
+    }
+
+    SECTION("Drink metrics") {
+        DrinkFacts beer;
+        beer.day = civil_date::days_from_civil(2022, 1, 1);
+        beer.abv = 5.0;
+        beer.size = 12.0;
+        beer.ibu = 40.0;
+        beer.rating = 7;
+        DrinkFacts unrated {beer};
+        unrated.ibu = -1.0;
+        unrated.rating = -1;
+
+        const std::vector<DrinkFacts> all_drinks {beer, unrated, beer};
+        REQUIRE(Histograms::metric_values(all_drinks, HistogramMetric::Ibu, 0.6) == std::vector<double>{40.0, 40.0});
+        REQUIRE(Histograms::metric_values(all_drinks, HistogramMetric::Rating, 0.6) == std::vector<double>{7.0, 7.0});
+        REQUIRE(Histograms::metric_values(all_drinks, HistogramMetric::Size, 0.6).size() == 3);
+        REQUIRE(Histograms::metric_values(all_drinks, HistogramMetric::StdDrinksPerDay, 0.6) ==
+                std::vector<double>{3.0});
+    }
+}
+
+TEST_CASE("Level of Detail Pyramid", "[Graph Data Compilation]") {
+    std::vector<double> keys(1000);
+    std::vector<double> values(1000);
+    for (std::size_t i = 0; i < keys.size(); i++) {
+        keys[i] = static_cast<double>(i);
+        values[i] = static_cast<double>(i % 7);
+    }
+    values[500] = 42.0;  // A spike that must survive decimation
+
+    const LodPyramid pyramid(keys, values);
+    REQUIRE(pyramid.levels() == 11);  // 1000, 500, 250, 125, 63, 32, 16, 8, 4, 2, 1
+    REQUIRE(pyramid.level(0).size() == 1000);
+    REQUIRE(pyramid.level(3).size() == 125);
+
+    const LodPoint &top {pyramid.level(pyramid.levels() - 1).front()};
+    REQUIRE(top.key == 0.0);
+    REQUIRE(top.last_key == 999.0);
+    REQUIRE(top.count == 1000);
+    REQUIRE(top.min == 0.0);
+    REQUIRE(top.max == 42.0);
+
+    // A wide plot, or a narrow range, gets the raw series
+    REQUIRE(pyramid.level_for(0, 999, 2000) == 0);
+    REQUIRE(pyramid.level_for(100, 199, 100) == 0);
+    REQUIRE(pyramid.visible(100, 199, 100).size() == 102);  // Plus one point either side
+
+    // 1000 points in 100 pixels: merging 8 into each still leaves 125, so level 4 merges 16 into each
+    REQUIRE(pyramid.level_for(0, 999, 100) == 4);
+    const std::vector<LodPoint> zoomed_out {pyramid.visible(0, 999, 100)};
+    REQUIRE(zoomed_out.size() <= 100);
+    double sum {0};
+    double max {0};
+    for (const LodPoint &point : zoomed_out) {
+        sum += point.sum;
+        max = std::max(max, point.max);
+    }
+    REQUIRE(sum == top.sum);
+    REQUIRE(max == 42.0);
+
+    REQUIRE(pyramid.visible(10, 5, 100).empty());
+    REQUIRE(LodPyramid().visible(0, 1, 100).empty());
+    REQUIRE(LodPyramid({1.0}, {3.0}).levels() == 1);
+}
@@ -0,0 +1,40 @@
+#ifndef BUZZBOT_TEST_HELPERS_H
+#define BUZZBOT_TEST_HELPERS_H
+
+#include "../src/drink.h"
+#include <string>
+
+inline Drink make_test_drink(const std::string &date, const std::string &name, const std::string &producer,
+                             const double abv = 8.4, const double ibu = 75.0,
+                             const std::string &alcohol_type = "Beer") {
+    /*
+     * A 12 oz IPA rated 8, ready to insert. Set anything else a test cares about on the result.
+     * @param date: Date drank, YYYY-MM-DD.
+     * @param name: Drink name.
+     * @param producer: Brewery, distillery or winery.
+     * @param abv: ABV, in percent.
+     * @param ibu: IBU, or -1 for none.
+     * @param alcohol_type: Beer, Liquor or Wine.
+     */
+
+    Drink drink;
+    drink.set_id(-1);
+    drink.set_date(date);
+    drink.set_name(name);
+    drink.set_type("IPA");
+    drink.set_subtype("");
+    drink.set_producer(producer);
+    drink.set_abv(abv);
+    drink.set_ibu(ibu);
+    drink.set_size(12.0);
+    drink.set_rating(8);
+    drink.set_notes("");
+    drink.set_vintage(-999);
+    drink.set_alcohol_type(alcohol_type);
+    drink.set_timestamp("2020-01-01 00:00:00");
+    drink.set_sort_order(1);
+    return drink;
+}
+
+
+#endif //BUZZBOT_TEST_HELPERS_H
@@ -0,0 +1,156 @@
+#include "../src/database.h"
+#include "../src/exporters.h"
+#include "../src/importers.h"
+#include "test_helpers.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#if __has_include("catch2/catch_test_macros.hpp")
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+using Catch::Approx;
+#else
+#include <catch2/catch.hpp>
+#endif
+
+TEST_CASE("CSV Round Trip", "[Import]") {
+    std::string current_path = std::filesystem::current_path();
+    const char *file_name = "testdb.db";
+    std::string db_path = current_path + "/" + file_name;
+    std::string csv_path = current_path + "/test_export.csv";
+
+    if (remove(db_path.c_str())) {
+        std::cout << "Removed existing testdb.sqlite file" << std::endl;
+    }
+
+    Storage storage_1 = initStorage(db_path);
+    Database::write_db_to_disk(storage_1);
+
+    Drink etrwo {make_test_drink("2020-09-08", "Everything Rhymes with Orange", "Roughtail Brewing", 8.0, 60.0)};
+    etrwo.set_subtype("Hazy IPA");
+    etrwo.set_notes("Very \"juicy\", hazy IPA.\nWill buy again.");
+    etrwo.set_timestamp("2020-09-08 20:00:00");
+
+    Drink cabernet {make_test_drink("2020-09-10", "Reserve", "Silver Oak", 14.5, -1, "Wine")};
+    cabernet.set_type("Red");
+    cabernet.set_subtype("Cabernet Sauvignon");
+    cabernet.set_size(5.0);
+    cabernet.set_rating(9);
+    cabernet.set_vintage(2016);
+    cabernet.set_timestamp("2020-09-10 21:00:00");
+
+    storage_1.insert(etrwo);
+    storage_1.insert(cabernet);
+
+    for (const std::string units : {"Imperial", "Metric"}) {
+        exporters::to_csv(storage_1, csv_path, units);
+
+        std::remove("testdb_import.db");
+        Storage storage_2 = initStorage(current_path + "/testdb_import.db");
+        Database::write_db_to_disk(storage_2);
+
+        ImportResult result = importers::from_csv(csv_path, storage_2);
+        REQUIRE(result.imported == 2);
+        REQUIRE(result.skipped == 0);
+
+        std::vector<Drink> imported = Database::read(storage_2);
+        REQUIRE(imported.size() == 2);
+        REQUIRE(imported.at(0).get_name() == "Everything Rhymes with Orange");
+        REQUIRE(imported.at(0).get_notes() == "Very \"juicy\", hazy IPA.\nWill buy again.");
+        REQUIRE(imported.at(0).get_vintage() == -999);
+        REQUIRE(imported.at(0).get_size() == Approx(12.0).epsilon(0.001));
+        REQUIRE(imported.at(1).get_ibu() == -1);
+        REQUIRE(imported.at(1).get_vintage() == 2016);
+        REQUIRE(imported.at(1).get_abv() == Approx(14.5));
+        REQUIRE(imported.at(1).get_timestamp() == "2020-09-10 21:00:00");
+    }
+
+    std::remove(csv_path.c_str());
+    std::remove("testdb_import.db");
+}
+
+TEST_CASE("CSV Import Skips Invalid Rows", "[Import]") {
+    std::string current_path = std::filesystem::current_path();
+    const char *file_name = "testdb.db";
+    std::string db_path = current_path + "/" + file_name;
+    std::string csv_path = current_path + "/test_import.csv";
+
+    if (remove(db_path.c_str())) {
+        std::cout << "Removed existing testdb.sqlite file" << std::endl;
+    }
+
+    Storage storage_1 = initStorage(db_path);
+    Database::write_db_to_disk(storage_1);
+
+    std::ofstream csv(csv_path);
+    csv << "Date,Name,Type,Subtype,Producer,Vintage,ABV,IBU,Size (oz),Rating,Notes,Alcohol Type,Timestamp,ID\r\n";
+    csv << "2020-09-08,\"Mosaic\",\"IPA\",\"\",\"Community Brewing\",,8.4,75,12,8,\"\",Beer,2020-09-08 00:00:00,7\r\n";
+    csv << "2020-09-09,\"Mosaic\",\"IPA\",\"\",\"Community Brewing\",,strong,75,12,8,\"\",Beer,,8\r\n";
+    csv << "2020-09-10,\"Mosaic\",\"IPA\"\r\n";
+    csv << "2020-09-11,\"Old \"Rasputin\" Stout\",\"Stout\",\"\",\"North Coast\",,9,75,12,8,\"\",Beer,,9\r\n";
+    for (const std::string date : {"abcd-ef-gh", "2021-13-45", "2021-02-30", "2021-9-1"}) {  // Invalid dates
+        csv << date << ",\"Mosaic\",\"IPA\",\"\",\"Community Brewing\",,8.4,75,12,8,\"\",Beer,,10\r\n";
+    }
+    csv.close();
+
+    ImportResult result = importers::from_csv(csv_path, storage_1);
+    REQUIRE(result.imported == 2);
+    REQUIRE(result.skipped == 6);
+    REQUIRE(result.errors.at(2).find("invalid date 'abcd-ef-gh'") != std::string::npos);
+    REQUIRE(Database::daily_totals(storage_1, 0, 0).empty());
+    REQUIRE(result.errors.at(0).rfind("Line 3", 0) == 0);
+
+    std::vector<Drink> imported = Database::read(storage_1);
+    REQUIRE(imported.at(0).get_id() == 1);
+    REQUIRE(imported.at(1).get_name() == "Old \"Rasputin\" Stout");
+
+    ImportResult missing = importers::from_csv(current_path + "/missing.csv", storage_1);
+    REQUIRE(missing.imported == 0);
+    REQUIRE(missing.errors.size() == 1);
+
+    std::remove(csv_path.c_str());
+}
+
+TEST_CASE("CSV Import Failing Midway", "[Import]") {
+    std::string current_path = std::filesystem::current_path();
+    const char *file_name = "testdb.db";
+    std::string db_path = current_path + "/" + file_name;
+    std::string csv_path = current_path + "/test_import.csv";
+
+    if (remove(db_path.c_str())) {
+        std::cout << "Removed existing testdb.sqlite file" << std::endl;
+    }
+
+    Storage storage_1 = initStorage(db_path);
+    Database::write_db_to_disk(storage_1);
+    storage_1.pragma.synchronous(2);
+    // Any insert of this drink fails, as a full disk or a locked database would
+    Database::execute(storage_1, "CREATE TRIGGER fail_import BEFORE INSERT ON drinks WHEN NEW.drink_name = 'Boom' "
+                                 "BEGIN SELECT RAISE(ABORT, 'boom'); END;");
+
+    std::ofstream csv(csv_path);
+    csv << "Date,Name,Type,Subtype,Producer,Vintage,ABV,IBU,Size (oz),Rating,Notes,Alcohol Type,Timestamp,ID\n";
+    for (const std::string name : {"Mosaic", "Citra", "Simcoe", "Boom", "Galaxy"}) {
+        csv << "2020-09-08,\"" << name << "\",\"IPA\",\"\",\"Community Brewing\",,8.4,75,12,8,\"\",Beer,,1\n";
+    }
+    csv.close();
+
+    // The first batch of two is committed. The second fails on its second row and is rolled back.
+    ImportResult result = importers::from_csv(csv_path, storage_1, 2);
+    REQUIRE(result.imported == 2);
+    REQUIRE(result.errors.size() == 1);
+    REQUIRE(result.errors.at(0).rfind("Import stopped at line 5", 0) == 0);
+    REQUIRE(Database::read(storage_1).size() == 2);
+
+    // The triggers and the pragma are put back, and the totals match the rows that were kept
+    const std::vector<DailyTotal> totals {Database::daily_totals(storage_1, 0, 100000)};
+    REQUIRE(totals.size() == 1);
+    REQUIRE(totals.at(0).drinks == 2);
+    REQUIRE(storage_1.pragma.synchronous() == 2);
+    Drink later {Database::read(storage_1).at(0)};
+    Database::write(later, storage_1);
+    REQUIRE(Database::daily_totals(storage_1, 0, 100000).at(0).drinks == 3);
+
+    std::remove(csv_path.c_str());
+}
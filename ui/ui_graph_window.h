@@ -11,28 +11,83 @@
 
 #include <QtCore/QVariant>
 #include <QtWidgets/QApplication>
+#include <QtWidgets/QComboBox>
 #include <QtWidgets/QDialog>
+#include <QtWidgets/QLabel>
 
 QT_BEGIN_NAMESPACE
 
 class Ui_GraphWindow
 {
 public:
+    QLabel *granularityLabel;
+    QComboBox *granularityComboBox;
+    QLabel *distributionLabel;
+    QComboBox *distributionComboBox;
+    QLabel *binsLabel;
+    QComboBox *binsComboBox;
 
     void setupUi(QDialog *GraphWindow)
     {
         if (GraphWindow->objectName().isEmpty())
             GraphWindow->setObjectName(QString::fromUtf8("GraphWindow"));
         GraphWindow->resize(826, 741);
+        granularityLabel = new QLabel(GraphWindow);
+        granularityLabel->setObjectName(QString::fromUtf8("granularityLabel"));
+        granularityLabel->setGeometry(QRect(8, 4, 60, 22));
+        granularityComboBox = new QComboBox(GraphWindow);
+        granularityComboBox->addItem(QString());
+        granularityComboBox->addItem(QString());
+        granularityComboBox->addItem(QString());
+        granularityComboBox->addItem(QString());
+        granularityComboBox->setObjectName(QString::fromUtf8("granularityComboBox"));
+        granularityComboBox->setGeometry(QRect(68, 4, 80, 22));
+        distributionLabel = new QLabel(GraphWindow);
+        distributionLabel->setObjectName(QString::fromUtf8("distributionLabel"));
+        distributionLabel->setGeometry(QRect(160, 4, 80, 22));
+        distributionComboBox = new QComboBox(GraphWindow);
+        distributionComboBox->addItem(QString());
+        distributionComboBox->addItem(QString());
+        distributionComboBox->addItem(QString());
+        distributionComboBox->addItem(QString());
+        distributionComboBox->addItem(QString());
+        distributionComboBox->setObjectName(QString::fromUtf8("distributionComboBox"));
+        distributionComboBox->setGeometry(QRect(240, 4, 150, 22));
+        binsLabel = new QLabel(GraphWindow);
+        binsLabel->setObjectName(QString::fromUtf8("binsLabel"));
+        binsLabel->setGeometry(QRect(400, 4, 30, 22));
+        binsComboBox = new QComboBox(GraphWindow);
+        binsComboBox->addItem(QString());
+        binsComboBox->addItem(QString());
+        binsComboBox->setObjectName(QString::fromUtf8("binsComboBox"));
+        binsComboBox->setGeometry(QRect(432, 4, 76, 22));
 
         retranslateUi(GraphWindow);
 
+        granularityComboBox->setCurrentIndex(1);
+
+
         QMetaObject::connectSlotsByName(GraphWindow);
     } // setupUi
 
     void retranslateUi(QDialog *GraphWindow)
     {
         GraphWindow->setWindowTitle(QCoreApplication::translate("GraphWindow", "Dialog", nullptr));
+        granularityLabel->setText(QCoreApplication::translate("GraphWindow", "Group by:", nullptr));
+        granularityComboBox->setItemText(0, QCoreApplication::translate("GraphWindow", "Day", nullptr));
+        granularityComboBox->setItemText(1, QCoreApplication::translate("GraphWindow", "Week", nullptr));
+        granularityComboBox->setItemText(2, QCoreApplication::translate("GraphWindow", "Month", nullptr));
+        granularityComboBox->setItemText(3, QCoreApplication::translate("GraphWindow", "Year", nullptr));
+        distributionLabel->setText(QCoreApplication::translate("GraphWindow", "Distribution:", nullptr));
+        distributionComboBox->setItemText(0, QCoreApplication::translate("GraphWindow", "IBU", nullptr));
+        distributionComboBox->setItemText(1, QCoreApplication::translate("GraphWindow", "ABV", nullptr));
+        distributionComboBox->setItemText(2, QCoreApplication::translate("GraphWindow", "Size", nullptr));
+        distributionComboBox->setItemText(3, QCoreApplication::translate("GraphWindow", "Rating", nullptr));
+        distributionComboBox->setItemText(4, QCoreApplication::translate("GraphWindow", "Std. drinks per day", nullptr));
+        binsLabel->setText(QCoreApplication::translate("GraphWindow", "Bins:", nullptr));
+        binsComboBox->setItemText(0, QCoreApplication::translate("GraphWindow", "Fixed", nullptr));
+        binsComboBox->setItemText(1, QCoreApplication::translate("GraphWindow", "Deciles", nullptr));
+
     } // retranslateUi
 
 };
@@ -24,7 +24,7 @@
 #include <QtWidgets/QSpacerItem>
 #include <QtWidgets/QSpinBox>
 #include <QtWidgets/QTabWidget>
-#include <QtWidgets/QTableWidget>
+#include <QtWidgets/QTableView>
 #include <QtWidgets/QTextEdit>
 #include <QtWidgets/QWidget>
 
@@ -42,7 +42,7 @@ public:
     QLabel *filterLabel;
     QLabel *filterCategoryLabel;
     QSpacerItem *verticalSpacer;
-    QTableWidget *drinkLogTable;
+    QTableView *drinkLogTable;
     QLabel *statsLabel;
     QFrame *frame;
     QGridLayout *gridLayout_5;
@@ -209,53 +209,7 @@ public:
 
         gridLayout_4->addWidget(frame_2, 4, 1, 2, 3);
 
-        drinkLogTable = new QTableWidget(centralwidget);
-        if (drinkLogTable->columnCount() < 13)
-            drinkLogTable->setColumnCount(13);
-        QTableWidgetItem *__qtablewidgetitem = new QTableWidgetItem();
-        drinkLogTable->setHorizontalHeaderItem(0, __qtablewidgetitem);
-        QTableWidgetItem *__qtablewidgetitem1 = new QTableWidgetItem();
-        drinkLogTable->setHorizontalHeaderItem(1, __qtablewidgetitem1);
-        QTableWidgetItem *__qtablewidgetitem2 = new QTableWidgetItem();
-        drinkLogTable->setHorizontalHeaderItem(2, __qtablewidgetitem2);
-        QTableWidgetItem *__qtablewidgetitem3 = new QTableWidgetItem();
-        drinkLogTable->setHorizontalHeaderItem(3, __qtablewidgetitem3);
-        QTableWidgetItem *__qtablewidgetitem4 = new QTableWidgetItem();
-        drinkLogTable->setHorizontalHeaderItem(4, __qtablewidgetitem4);
-        QTableWidgetItem *__qtablewidgetitem5 = new QTableWidgetItem();
-        drinkLogTable->setHorizontalHeaderItem(5, __qtablewidgetitem5);
-        QTableWidgetItem *__qtablewidgetitem6 = new QTableWidgetItem();
-        drinkLogTable->setHorizontalHeaderItem(6, __qtablewidgetitem6);
-        QTableWidgetItem *__qtablewidgetitem7 = new QTableWidgetItem();
-        drinkLogTable->setHorizontalHeaderItem(7, __qtablewidgetitem7);
-        QTableWidgetItem *__qtablewidgetitem8 = new QTableWidgetItem();
-        drinkLogTable->setHorizontalHeaderItem(8, __qtablewidgetitem8);
-        QTableWidgetItem *__qtablewidgetitem9 = new QTableWidgetItem();
-        drinkLogTable->setHorizontalHeaderItem(9, __qtablewidgetitem9);
-        QTableWidgetItem *__qtablewidgetitem10 = new QTableWidgetItem();
-        drinkLogTable->setHorizontalHeaderItem(10, __qtablewidgetitem10);
-        QTableWidgetItem *__qtablewidgetitem11 = new QTableWidgetItem();
-        drinkLogTable->setHorizontalHeaderItem(11, __qtablewidgetitem11);
-        QTableWidgetItem *__qtablewidgetitem12 = new QTableWidgetItem();
-        drinkLogTable->setHorizontalHeaderItem(12, __qtablewidgetitem12);
-        if (drinkLogTable->rowCount() < 1)
-            drinkLogTable->setRowCount(1);
-        QTableWidgetItem *__qtablewidgetitem13 = new QTableWidgetItem();
-        drinkLogTable->setVerticalHeaderItem(0, __qtablewidgetitem13);
-        QTableWidgetItem *__qtablewidgetitem14 = new QTableWidgetItem();
-        drinkLogTable->setItem(0, 0, __qtablewidgetitem14);
-        QTableWidgetItem *__qtablewidgetitem15 = new QTableWidgetItem();
-        drinkLogTable->setItem(0, 1, __qtablewidgetitem15);
-        QTableWidgetItem *__qtablewidgetitem16 = new QTableWidgetItem();
-        drinkLogTable->setItem(0, 2, __qtablewidgetitem16);
-        QTableWidgetItem *__qtablewidgetitem17 = new QTableWidgetItem();
-        drinkLogTable->setItem(0, 4, __qtablewidgetitem17);
-        QTableWidgetItem *__qtablewidgetitem18 = new QTableWidgetItem();
-        drinkLogTable->setItem(0, 5, __qtablewidgetitem18);
-        QTableWidgetItem *__qtablewidgetitem19 = new QTableWidgetItem();
-        drinkLogTable->setItem(0, 6, __qtablewidgetitem19);
-        QTableWidgetItem *__qtablewidgetitem20 = new QTableWidgetItem();
-        drinkLogTable->setItem(0, 7, __qtablewidgetitem20);
+        drinkLogTable = new QTableView(centralwidget);
         drinkLogTable->setObjectName(QString::fromUtf8("drinkLogTable"));
         QSizePolicy sizePolicy2(QSizePolicy::Preferred, QSizePolicy::MinimumExpanding);
         sizePolicy2.setHorizontalStretch(0);
@@ -1035,52 +989,6 @@ public:
         MainWindow->setWindowTitle(QCoreApplication::translate("MainWindow", "BuzzBot", nullptr));
         filterLabel->setText(QCoreApplication::translate("MainWindow", "Filter", nullptr));
         filterCategoryLabel->setText(QCoreApplication::translate("MainWindow", "Filter Category", nullptr));
-        QTableWidgetItem *___qtablewidgetitem = drinkLogTable->horizontalHeaderItem(0);
-        ___qtablewidgetitem->setText(QCoreApplication::translate("MainWindow", "Date", nullptr));
-        QTableWidgetItem *___qtablewidgetitem1 = drinkLogTable->horizontalHeaderItem(1);
-        ___qtablewidgetitem1->setText(QCoreApplication::translate("MainWindow", "Name", nullptr));
-        QTableWidgetItem *___qtablewidgetitem2 = drinkLogTable->horizontalHeaderItem(2);
-        ___qtablewidgetitem2->setText(QCoreApplication::translate("MainWindow", "Type", nullptr));
-        QTableWidgetItem *___qtablewidgetitem3 = drinkLogTable->horizontalHeaderItem(3);
-        ___qtablewidgetitem3->setText(QCoreApplication::translate("MainWindow", "Subtype", nullptr));
-        QTableWidgetItem *___qtablewidgetitem4 = drinkLogTable->horizontalHeaderItem(4);
-        ___qtablewidgetitem4->setText(QCoreApplication::translate("MainWindow", "Producer", nullptr));
-        QTableWidgetItem *___qtablewidgetitem5 = drinkLogTable->horizontalHeaderItem(5);
-        ___qtablewidgetitem5->setText(QCoreApplication::translate("MainWindow", "ABV", nullptr));
-        QTableWidgetItem *___qtablewidgetitem6 = drinkLogTable->horizontalHeaderItem(6);
-        ___qtablewidgetitem6->setText(QCoreApplication::translate("MainWindow", "IBU", nullptr));
-        QTableWidgetItem *___qtablewidgetitem7 = drinkLogTable->horizontalHeaderItem(7);
-        ___qtablewidgetitem7->setText(QCoreApplication::translate("MainWindow", "Size", nullptr));
-        QTableWidgetItem *___qtablewidgetitem8 = drinkLogTable->horizontalHeaderItem(8);
-        ___qtablewidgetitem8->setText(QCoreApplication::translate("MainWindow", "S. Drinks", nullptr));
-        QTableWidgetItem *___qtablewidgetitem9 = drinkLogTable->horizontalHeaderItem(9);
-        ___qtablewidgetitem9->setText(QCoreApplication::translate("MainWindow", "Rating", nullptr));
-        QTableWidgetItem *___qtablewidgetitem10 = drinkLogTable->horizontalHeaderItem(10);
-        ___qtablewidgetitem10->setText(QCoreApplication::translate("MainWindow", "ID", nullptr));
-        QTableWidgetItem *___qtablewidgetitem11 = drinkLogTable->horizontalHeaderItem(11);
-        ___qtablewidgetitem11->setText(QCoreApplication::translate("MainWindow", "Timestamp", nullptr));
-        QTableWidgetItem *___qtablewidgetitem12 = drinkLogTable->horizontalHeaderItem(12);
-        ___qtablewidgetitem12->setText(QCoreApplication::translate("MainWindow", "Sort", nullptr));
-        QTableWidgetItem *___qtablewidgetitem13 = drinkLogTable->verticalHeaderItem(0);
-        ___qtablewidgetitem13->setText(QCoreApplication::translate("MainWindow", "1", nullptr));
-
-        const bool __sortingEnabled = drinkLogTable->isSortingEnabled();
-        drinkLogTable->setSortingEnabled(false);
-        QTableWidgetItem *___qtablewidgetitem14 = drinkLogTable->item(0, 0);
-        ___qtablewidgetitem14->setText(QCoreApplication::translate("MainWindow", "09/07/2020", nullptr));
-        QTableWidgetItem *___qtablewidgetitem15 = drinkLogTable->item(0, 1);
-        ___qtablewidgetitem15->setText(QCoreApplication::translate("MainWindow", "Everything Rhymes with Orange", nullptr));
-        QTableWidgetItem *___qtablewidgetitem16 = drinkLogTable->item(0, 2);
-        ___qtablewidgetitem16->setText(QCoreApplication::translate("MainWindow", "IPA", nullptr));
-        QTableWidgetItem *___qtablewidgetitem17 = drinkLogTable->item(0, 4);
-        ___qtablewidgetitem17->setText(QCoreApplication::translate("MainWindow", "Roughtail Brewing", nullptr));
-        QTableWidgetItem *___qtablewidgetitem18 = drinkLogTable->item(0, 5);
-        ___qtablewidgetitem18->setText(QCoreApplication::translate("MainWindow", "8.0", nullptr));
-        QTableWidgetItem *___qtablewidgetitem19 = drinkLogTable->item(0, 6);
-        ___qtablewidgetitem19->setText(QCoreApplication::translate("MainWindow", "65", nullptr));
-        QTableWidgetItem *___qtablewidgetitem20 = drinkLogTable->item(0, 7);
-        ___qtablewidgetitem20->setText(QCoreApplication::translate("MainWindow", "12", nullptr));
-        drinkLogTable->setSortingEnabled(__sortingEnabled);
 
         statsLabel->setText(QCoreApplication::translate("MainWindow", "Stats", nullptr));
         drinksLeftOutput->setText(QCoreApplication::translate("MainWindow", "4", nullptr));